@@ -15,7 +15,7 @@ const char bc_help[] = {
   101,110,103,114,111,117,112,46,111,114,103,47,111,110,108,105,110,101,112,117,
   98,115,47,57,54,57,57,57,49,57,55,57,57,47,117,116,105,108,105,116,105,101,
   115,47,98,99,46,104,116,109,108,41,10,102,111,114,32,100,101,116,97,105,108,
-  115,46,10,10,84,104,105,115,32,98,99,32,104,97,115,32,102,111,117,114,32,100,
+  115,46,10,10,84,104,105,115,32,98,99,32,104,97,115,32,102,105,118,101,32,100,
   105,102,102,101,114,101,110,99,101,115,32,116,111,32,116,104,101,32,71,78,85,
   32,98,99,58,10,10,32,32,49,41,32,84,104,101,32,112,101,114,105,111,100,32,40,
   46,41,32,99,97,110,32,97,108,115,111,32,98,101,32,117,115,101,100,32,97,115,
@@ -47,57 +47,70 @@ const char bc_help[] = {
   111,109,101,119,104,97,116,32,112,114,101,115,101,114,118,105,110,103,32,101,
   120,112,101,99,116,101,100,32,98,101,104,97,118,105,111,114,32,40,118,101,114,
   115,117,115,32,67,41,32,97,110,100,10,32,32,32,32,32,109,97,107,105,110,103,
-  32,112,97,114,115,105,110,103,32,101,97,115,105,101,114,46,10,10,79,112,116,
-  105,111,110,115,58,10,10,32,32,45,101,32,101,120,112,114,32,32,45,45,101,120,
-  112,114,101,115,115,105,111,110,61,101,120,112,114,10,32,32,32,32,32,32,32,
-  32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,114,117,110,32,34,101,
-  120,112,114,34,32,97,110,100,32,113,117,105,116,46,32,73,102,32,109,117,108,
-  116,105,112,108,101,32,101,120,112,114,101,115,115,105,111,110,115,32,111,114,
-  32,102,105,108,101,115,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,32,32,32,32,40,115,101,101,32,98,101,108,111,119,41,32,97,114,101,
-  32,103,105,118,101,110,44,32,116,104,101,121,32,97,114,101,32,97,108,108,32,
-  114,117,110,46,10,32,32,45,102,32,32,102,105,108,101,32,32,45,45,102,105,108,
-  101,61,102,105,108,101,32,32,114,117,110,32,116,104,101,32,98,99,32,99,111,
-  100,101,32,105,110,32,34,102,105,108,101,34,32,97,110,100,32,101,120,105,116,
-  46,32,83,101,101,32,97,98,111,118,101,32,97,115,32,119,101,108,108,46,10,32,
-  32,45,104,32,32,45,45,104,101,108,112,32,32,32,32,32,32,32,32,32,32,32,32,32,
-  112,114,105,110,116,32,116,104,105,115,32,117,115,97,103,101,32,109,101,115,
-  115,97,103,101,32,97,110,100,32,101,120,105,116,10,32,32,45,105,32,32,45,45,
-  105,110,116,101,114,97,99,116,105,118,101,32,32,32,32,32,32,102,111,114,99,
-  101,32,105,110,116,101,114,97,99,116,105,118,101,32,109,111,100,101,10,32,32,
-  45,108,32,32,45,45,109,97,116,104,108,105,98,32,32,32,32,32,32,32,32,32,32,
-  117,115,101,32,112,114,101,100,101,102,105,110,101,100,32,109,97,116,104,32,
-  114,111,117,116,105,110,101,115,58,10,10,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,115,40,101,120,112,114,41,32,32,
-  61,32,32,115,105,110,101,32,111,102,32,101,120,112,114,32,105,110,32,114,97,
-  100,105,97,110,115,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,32,32,32,32,32,99,40,101,120,112,114,41,32,32,61,32,32,99,111,115,
+  32,112,97,114,115,105,110,103,32,101,97,115,105,101,114,46,10,32,32,53,41,32,
+  84,104,101,114,101,32,105,115,32,97,32,98,117,105,108,116,105,110,32,34,109,
+  111,100,101,120,112,34,32,102,117,110,99,116,105,111,110,58,32,109,111,100,
+  101,120,112,40,97,44,32,98,44,32,99,41,32,105,115,32,97,94,98,32,109,111,100,
+  32,99,44,32,102,111,114,10,32,32,32,32,32,105,110,116,101,103,101,114,115,32,
+  97,44,32,98,32,97,110,100,32,99,44,32,119,105,116,104,32,98,32,110,111,116,
+  32,110,101,103,97,116,105,118,101,44,32,97,110,100,32,105,116,32,119,111,114,
+  107,115,32,119,105,116,104,32,110,117,109,98,101,114,115,32,116,104,97,116,
+  10,32,32,32,32,32,97,114,101,32,102,97,114,32,116,111,111,32,98,105,103,32,
+  102,111,114,32,97,94,98,32,116,111,32,98,101,32,99,111,109,112,117,116,101,
+  100,32,102,105,114,115,116,46,32,84,104,101,32,102,111,108,108,111,119,105,
+  110,103,32,101,120,97,109,112,108,101,32,112,114,105,110,116,115,10,32,32,32,
+  32,32,34,52,52,53,34,58,10,10,32,32,32,32,32,32,32,109,111,100,101,120,112,
+  40,52,44,32,49,51,44,32,52,57,55,41,10,10,79,112,116,105,111,110,115,58,10,
+  10,32,32,45,101,32,101,120,112,114,32,32,45,45,101,120,112,114,101,115,115,
+  105,111,110,61,101,120,112,114,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,32,32,32,32,32,32,32,32,32,32,114,117,110,32,34,101,120,112,114,34,32,97,
+  110,100,32,113,117,105,116,46,32,73,102,32,109,117,108,116,105,112,108,101,
+  32,101,120,112,114,101,115,115,105,111,110,115,32,111,114,32,102,105,108,101,
+  115,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,32,40,115,101,101,32,98,101,108,111,119,41,32,97,114,101,32,103,105,118,
+  101,110,44,32,116,104,101,121,32,97,114,101,32,97,108,108,32,114,117,110,46,
+  10,32,32,45,102,32,32,102,105,108,101,32,32,45,45,102,105,108,101,61,102,105,
+  108,101,32,32,114,117,110,32,116,104,101,32,98,99,32,99,111,100,101,32,105,
+  110,32,34,102,105,108,101,34,32,97,110,100,32,101,120,105,116,46,32,83,101,
+  101,32,97,98,111,118,101,32,97,115,32,119,101,108,108,46,10,32,32,45,104,32,
+  32,45,45,104,101,108,112,32,32,32,32,32,32,32,32,32,32,32,32,32,112,114,105,
+  110,116,32,116,104,105,115,32,117,115,97,103,101,32,109,101,115,115,97,103,
+  101,32,97,110,100,32,101,120,105,116,10,32,32,45,105,32,32,45,45,105,110,116,
+  101,114,97,99,116,105,118,101,32,32,32,32,32,32,102,111,114,99,101,32,105,110,
+  116,101,114,97,99,116,105,118,101,32,109,111,100,101,10,32,32,45,108,32,32,
+  45,45,109,97,116,104,108,105,98,32,32,32,32,32,32,32,32,32,32,117,115,101,32,
+  112,114,101,100,101,102,105,110,101,100,32,109,97,116,104,32,114,111,117,116,
+  105,110,101,115,58,10,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,32,32,32,32,32,32,32,32,32,115,40,101,120,112,114,41,32,32,61,32,32,115,
   105,110,101,32,111,102,32,101,120,112,114,32,105,110,32,114,97,100,105,97,110,
   115,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,97,40,101,120,112,114,41,32,32,61,32,32,97,114,99,116,97,110,103,
-  101,110,116,32,111,102,32,101,120,112,114,44,32,114,101,116,117,114,110,105,
-  110,103,32,114,97,100,105,97,110,115,10,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,108,40,101,120,112,114,41,32,32,
-  61,32,32,110,97,116,117,114,97,108,32,108,111,103,32,111,102,32,101,120,112,
-  114,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,101,40,101,120,112,114,41,32,32,61,32,32,114,97,105,115,101,115,
-  32,101,32,116,111,32,116,104,101,32,112,111,119,101,114,32,111,102,32,101,120,
-  112,114,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
-  32,32,32,32,32,106,40,110,44,32,120,41,32,32,61,32,32,66,101,115,115,101,108,
-  32,102,117,110,99,116,105,111,110,32,111,102,32,105,110,116,101,103,101,114,
-  32,111,114,100,101,114,32,110,32,111,102,32,120,10,10,32,32,45,113,32,32,45,
-  45,113,117,105,101,116,32,32,32,32,32,32,32,32,32,32,32,32,100,111,110,39,116,
-  32,112,114,105,110,116,32,118,101,114,115,105,111,110,32,97,110,100,32,99,111,
-  112,121,114,105,103,104,116,10,32,32,45,115,32,32,45,45,115,116,97,110,100,
-  97,114,100,32,32,32,32,32,32,32,32,32,101,114,114,111,114,32,105,102,32,97,
-  110,121,32,110,111,110,45,80,79,83,73,88,32,101,120,116,101,110,115,105,111,
-  110,115,32,97,114,101,32,117,115,101,100,10,32,32,45,119,32,32,45,45,119,97,
-  114,110,32,32,32,32,32,32,32,32,32,32,32,32,32,119,97,114,110,32,105,102,32,
-  97,110,121,32,110,111,110,45,80,79,83,73,88,32,101,120,116,101,110,115,105,
-  111,110,115,32,97,114,101,32,117,115,101,100,10,32,32,45,118,32,32,45,45,118,
-  101,114,115,105,111,110,32,32,32,32,32,32,32,32,32,32,112,114,105,110,116,32,
-  118,101,114,115,105,111,110,32,105,110,102,111,114,109,97,116,105,111,110,32,
-  97,110,100,32,99,111,112,121,114,105,103,104,116,32,97,110,100,32,101,120,105,
-  116,10,0
+  32,32,32,32,99,40,101,120,112,114,41,32,32,61,32,32,99,111,115,105,110,101,
+  32,111,102,32,101,120,112,114,32,105,110,32,114,97,100,105,97,110,115,10,32,
+  32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,97,40,101,120,112,114,41,32,32,61,32,32,97,114,99,116,97,110,103,101,110,
+  116,32,111,102,32,101,120,112,114,44,32,114,101,116,117,114,110,105,110,103,
+  32,114,97,100,105,97,110,115,10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,32,32,32,32,32,32,32,32,32,32,32,108,40,101,120,112,114,41,32,32,61,32,32,
+  110,97,116,117,114,97,108,32,108,111,103,32,111,102,32,101,120,112,114,10,32,
+  32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,101,40,101,120,112,114,41,32,32,61,32,32,114,97,105,115,101,115,32,101,32,
+  116,111,32,116,104,101,32,112,111,119,101,114,32,111,102,32,101,120,112,114,
+  10,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+  32,32,32,106,40,110,44,32,120,41,32,32,61,32,32,66,101,115,115,101,108,32,102,
+  117,110,99,116,105,111,110,32,111,102,32,105,110,116,101,103,101,114,32,111,
+  114,100,101,114,32,110,32,111,102,32,120,10,10,32,32,45,113,32,32,45,45,113,
+  117,105,101,116,32,32,32,32,32,32,32,32,32,32,32,32,100,111,110,39,116,32,112,
+  114,105,110,116,32,118,101,114,115,105,111,110,32,97,110,100,32,99,111,112,
+  121,114,105,103,104,116,10,32,32,45,115,32,32,45,45,115,116,97,110,100,97,114,
+  100,32,32,32,32,32,32,32,32,32,101,114,114,111,114,32,105,102,32,97,110,121,
+  32,110,111,110,45,80,79,83,73,88,32,101,120,116,101,110,115,105,111,110,115,
+  32,97,114,101,32,117,115,101,100,10,32,32,45,119,32,32,45,45,119,97,114,110,
+  32,32,32,32,32,32,32,32,32,32,32,32,32,119,97,114,110,32,105,102,32,97,110,
+  121,32,110,111,110,45,80,79,83,73,88,32,101,120,116,101,110,115,105,111,110,
+  115,32,97,114,101,32,117,115,101,100,10,32,32,45,118,32,32,45,45,118,101,114,
+  115,105,111,110,32,32,32,32,32,32,32,32,32,32,112,114,105,110,116,32,118,101,
+  114,115,105,111,110,32,105,110,102,111,114,109,97,116,105,111,110,32,97,110,
+  100,32,99,111,112,121,114,105,103,104,116,32,97,110,100,32,101,120,105,116,
+  10,0
 };
 #endif // BC_ENABLED
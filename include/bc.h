@@ -47,14 +47,15 @@ typedef struct BcLexKeyword {
 
 #define BC_LEX_KW_ENTRY(a, b, c) { .name = a, .len = (b), .posix = (c) }
 
-extern const BcLexKeyword bc_lex_kws[20];
+extern const BcLexKeyword bc_lex_kws[21];
 
 BcStatus bc_lex_token(BcLex *l);
 
 #define BC_PARSE_TOP_OP(p) (*((BcLexType*) bc_vec_top(&(p)->ops)))
 #define BC_PARSE_LEAF(p, rparen) \
 	(((p) >= BC_INST_NUM && (p) <= BC_INST_SQRT) || (rparen) || \
-	(p) == BC_INST_INC_POST || (p) == BC_INST_DEC_POST)
+	(p) == BC_INST_INC_POST || (p) == BC_INST_DEC_POST || \
+	(p) == BC_INST_MODEXP)
 
 // We can calculate the conversion between tokens and exprs by subtracting the
 // position of the first operator in the lex enum and adding the position of the
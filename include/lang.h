@@ -102,8 +102,9 @@ typedef enum BcInst {
 	BC_INST_POP,
 	BC_INST_POP_EXEC,
 
-#ifdef DC_ENABLED
 	BC_INST_MODEXP,
+
+#ifdef DC_ENABLED
 	BC_INST_DIVMOD,
 
 	BC_INST_EXECUTE,
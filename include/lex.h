@@ -105,6 +105,7 @@ typedef enum BcLexType {
 	BC_LEX_KEY_SCALE,
 	BC_LEX_KEY_SQRT,
 	BC_LEX_KEY_WHILE,
+	BC_LEX_KEY_MODEXP,
 
 #ifdef DC_ENABLED
 	BC_LEX_EQ_NO_REG,
@@ -25,24 +25,70 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include <status.h>
 
-typedef signed char BcDig;
-
+typedef int32_t BcDig;
+typedef uint64_t BcBigDig;
+
+#ifndef BC_NUM_BINARY
+#define BC_NUM_BINARY (0)
+#endif // BC_NUM_BINARY
+
+#if BC_NUM_BINARY
+typedef uint32_t BcBinDig;
+#endif // BC_NUM_BINARY
+
+// Each BcDig is a limb holding BC_BASE_DIGS decimal digits, little-endian. The
+// limbs are aligned on the radix point: rdx is the number of fractional limbs,
+// scale is the number of fractional decimal digits, and len and cap are in
+// limbs. Any digits below scale in the lowest limb are always zero.
+//
+// Only the nonzero part of a number is stored: num[0] is limb off of the whole
+// number, the off limbs below it are zero, and so is everything above len,
+// including any fractional limbs above the first nonzero one. A clean nonzero
+// number has nonzero num[0] and num[len - 1], and zero has len and off of 0.
+//
+// With BC_NUM_BINARY, integers that come out of integer operations are instead
+// kept in binary: if bin is set, num holds len BcBinDig words, little-endian,
+// and rdx, scale and off are 0. They are converted to decimal only when that
+// is needed, such as to print them in base 10 or to give them a scale.
 typedef struct BcNum {
 	BcDig *restrict num;
 	size_t rdx;
+	size_t scale;
+	size_t off;
 	size_t len;
 	size_t cap;
 	bool neg;
+#if BC_NUM_BINARY
+	bool bin;
+#endif // BC_NUM_BINARY
 } BcNum;
 
+#define BC_BASE_DIGS (9)
+#define BC_BASE_POW (1000000000)
+
 #define BC_NUM_MIN_BASE ((unsigned long) 2)
 #define BC_NUM_MAX_IBASE ((unsigned long) 16)
-#define BC_NUM_DEF_SIZE (16)
+#define BC_NUM_DEF_SIZE (8)
 #define BC_NUM_PRINT_WIDTH (69)
+#define BC_NUM_PRINT_BUF (1024)
+#define BC_NUM_BLOCK_LEN (64)
+
+// Strings of up to this many limbs' worth of digits in bases other than 10 are
+// parsed a limb at a time; longer ones are split in halves.
+#define BC_NUM_PARSE_LEN (32)
+
+// With BC_NUM_BINARY, numbers of up to this many limbs or words are converted
+// between decimal and binary a word at a time; longer ones are split in halves.
+// Longer integer literals in bases other than powers of two stay in decimal.
+#define BC_NUM_BIN_LEN (64)
+
+// The most products of two limbs that fit in a BcBigDig along with a carry.
+#define BC_NUM_COMBA_LEN (16)
 
 #ifndef BC_NUM_KARATSUBA_LEN
 #define BC_NUM_KARATSUBA_LEN (32)
@@ -50,13 +96,104 @@ typedef struct BcNum {
 #error BC_NUM_KARATSUBA_LEN must be at least 2
 #endif // BC_NUM_KARATSUBA_LEN
 
+// Products that are truncated are only computed in part (a short product)
+// below this many limbs; above it, Karatsuba is faster in full.
+#define BC_NUM_SHORT_LEN (6 * BC_NUM_KARATSUBA_LEN)
+
+// Karatsuba does not split numbers shorter than this, whatever
+// BC_NUM_KARATSUBA_LEN is, because they would not get any shorter.
+#define BC_NUM_KARATSUBA_MIN (4)
+
+#ifndef BC_NUM_TOOM3_LEN
+#define BC_NUM_TOOM3_LEN (400)
+#elif BC_NUM_TOOM3_LEN < 3
+#error BC_NUM_TOOM3_LEN must be at least 3
+#endif // BC_NUM_TOOM3_LEN
+
+#ifndef BC_NUM_TOOM4_LEN
+#define BC_NUM_TOOM4_LEN (2000)
+#elif BC_NUM_TOOM4_LEN < 3
+#error BC_NUM_TOOM4_LEN must be at least 3
+#endif // BC_NUM_TOOM4_LEN
+
+#ifndef BC_NUM_NTT_LEN
+#define BC_NUM_NTT_LEN (6000)
+#elif BC_NUM_NTT_LEN < 2
+#error BC_NUM_NTT_LEN must be at least 2
+#endif // BC_NUM_NTT_LEN
+
+#ifndef BC_NUM_NEWTON_LEN
+#define BC_NUM_NEWTON_LEN (60)
+#elif BC_NUM_NEWTON_LEN < 8
+#error BC_NUM_NEWTON_LEN must be at least 8
+#endif // BC_NUM_NEWTON_LEN
+
+// Integers longer than this are printed in bases other than 10 by splitting
+// them with divisions by powers of the base; shorter ones are printed a word
+// at a time.
+#ifndef BC_NUM_PRINT_LEN
+#define BC_NUM_PRINT_LEN (32)
+#elif BC_NUM_PRINT_LEN < 2
+#error BC_NUM_PRINT_LEN must be at least 2
+#endif // BC_NUM_PRINT_LEN
+
+// Powers multiply by precomputed powers of the base for up to this many bits of
+// the exponent at a time.
+#define BC_NUM_WINDOW (6)
+
+// The NTT primes all have roots of unity of order 2^25, and the product of the
+// primes is more than 2^25 times (BC_BASE_POW - 1)^2, so any product with up
+// to this many limbs can be done with them.
+#define BC_NUM_NTT_PRIMES (3)
+#define BC_NUM_NTT_MAX ((size_t) 1 << 25)
+
+// Reciprocals found for Newton division are kept in a cache, keyed on the
+// divisor and the precision, so that dividing by the same number again does
+// not have to find them again. It holds at most BC_NUM_RECIP_CACHE of them, in
+// at most BC_NUM_RECIP_LIMBS limbs, and the least recently used goes first.
+#define BC_NUM_RECIP_CACHE (8)
+#define BC_NUM_RECIP_LIMBS ((size_t) 1 << 20)
+
+// The limbs of numbers with room for only BC_NUM_DEF_SIZE of them, which are
+// most numbers, are kept when they are freed, up to BC_NUM_POOL_LEN at a time,
+// and given to the next such number instead of a new allocation.
+#define BC_NUM_POOL_LEN (64)
+
+// If set, the hits and misses of the cache are printed to stderr on exit.
+#ifndef BC_NUM_CACHE_STATS
+#define BC_NUM_CACHE_STATS (0)
+#endif // BC_NUM_CACHE_STATS
+
 #define BC_NUM_NEG(n, neg) ((((ssize_t) (n)) ^ -((ssize_t) (neg))) + (neg))
-#define BC_NUM_ONE(n) ((n)->len == 1 && (n)->rdx == 0 && (n)->num[0] == 1)
-#define BC_NUM_INT(n) ((n)->len - (n)->rdx)
-#define BC_NUM_AREQ(a, b) \
-	(BC_MAX((a)->rdx, (b)->rdx) + BC_MAX(BC_NUM_INT(a), BC_NUM_INT(b)) + 1)
-#define BC_NUM_MREQ(a, b, scale) \
-	(BC_NUM_INT(a) + BC_NUM_INT(b) + BC_MAX((scale), (a)->rdx + (b)->rdx) + 1)
+#define BC_NUM_ONE(n) \
+	((n)->len == 1 && (n)->off == 0 && (n)->rdx == 0 && (n)->num[0] == 1)
+#define BC_NUM_TOP(n) ((n)->off + (n)->len)
+#define BC_NUM_INT(n) \
+	(BC_NUM_TOP(n) > (n)->rdx ? BC_NUM_TOP(n) - (n)->rdx : 0)
+#define BC_NUM_RDX(s) ((s) / BC_BASE_DIGS + ((s) % BC_BASE_DIGS != 0))
+#define BC_NUM_AREQ(a, b) (BC_MAX((a)->len, (b)->len) + 1)
+#define BC_NUM_MREQ(a, b) ((a)->len + (b)->len + 1)
+
+typedef struct BcNumRecip {
+	BcNum y;
+	BcNum x;
+	size_t h;
+	size_t used;
+} BcNumRecip;
+
+typedef struct BcNumCache {
+	BcNumRecip recips[BC_NUM_RECIP_CACHE];
+	size_t len;
+	size_t limbs;
+	size_t clock;
+	size_t hits;
+	size_t misses;
+} BcNumCache;
+
+typedef struct BcNumPool {
+	BcDig *nums[BC_NUM_POOL_LEN];
+	size_t len;
+} BcNumPool;
 
 typedef BcStatus (*BcNumBinaryOp)(BcNum*, BcNum*, BcNum*, size_t);
 typedef void (*BcNumDigitOp)(size_t, size_t, bool, size_t*, size_t);
@@ -65,6 +202,8 @@ void bc_num_init(BcNum *n, size_t req);
 void bc_num_expand(BcNum *n, size_t req);
 void bc_num_copy(BcNum *d, BcNum *s);
 void bc_num_free(void *num);
+void bc_num_cacheFree(BcNumCache *cache);
+void bc_num_poolFree(BcNumPool *pool);
 
 BcStatus bc_num_ulong(BcNum *n, unsigned long *result);
 BcStatus bc_num_ulong2num(BcNum *n, unsigned long val);
@@ -83,10 +222,9 @@ BcStatus bc_num_divmod(BcNum *a, BcNum *b, BcNum *c, BcNum *d, size_t scale);
 
 void bc_num_truncate(BcNum *n, size_t places);
 ssize_t bc_num_cmp(BcNum *a, BcNum *b);
+size_t bc_num_len(BcNum *n);
 
-#ifdef DC_ENABLED
 BcStatus bc_num_modexp(BcNum *a, BcNum *b, BcNum *c, BcNum *restrict d);
-#endif // DC_ENABLED
 
 void bc_num_zero(BcNum *n);
 void bc_num_one(BcNum *n);
@@ -101,5 +239,8 @@ BcStatus bc_num_stream(BcNum *n, BcNum *base, size_t *nchars, size_t len);
 // ** Exclude end. **
 
 extern const char bc_num_hex_digits[];
+extern const BcBigDig bc_num_pow10[BC_BASE_DIGS + 1];
+extern const uint32_t bc_num_ntt_primes[BC_NUM_NTT_PRIMES];
+extern const uint32_t bc_num_ntt_roots[BC_NUM_NTT_PRIMES];
 
 #endif // BC_NUM_H
@@ -108,6 +108,9 @@ typedef struct BcGlobals {
 	const char *help;
 	bool bc;
 
+	BcNumCache cache;
+	BcNumPool pool;
+
 } BcGlobals;
 // ** Exclude end. **
 
@@ -120,6 +123,7 @@ void bc_vm_exit(BcStatus s);
 void bc_vm_printf(FILE *restrict f, const char *fmt, ...);
 void bc_vm_puts(const char *str, FILE *restrict f);
 void bc_vm_putchar(int c);
+void bc_vm_write(const char *str, size_t len);
 void bc_vm_fflush(FILE *restrict f);
 
 // ** Exclude start. **
@@ -257,6 +257,36 @@ BcStatus bc_parse_builtin(BcParse *p, BcLexType type,
 	return bc_lex_next(&p->l);
 }
 
+BcStatus bc_parse_modexp(BcParse *p, uint8_t flags, BcInst *prev) {
+
+	BcStatus s;
+	size_t i;
+
+	s = bc_lex_next(&p->l);
+	if (s) return s;
+	if (p->l.t.t != BC_LEX_LPAREN) return BC_STATUS_PARSE_BAD_TOKEN;
+
+	flags &= ~(BC_PARSE_PRINT | BC_PARSE_REL | BC_PARSE_ARRAY);
+
+	for (i = 0; i < 3; ++i) {
+
+		s = bc_lex_next(&p->l);
+		if (s) return s;
+
+		s = bc_parse_expr(p, flags, i < 2 ? bc_parse_next_param :
+		                                    bc_parse_next_rel);
+		if (s) return s;
+
+		if (p->l.t.t != (i < 2 ? BC_LEX_COMMA : BC_LEX_RPAREN))
+			return BC_STATUS_PARSE_BAD_TOKEN;
+	}
+
+	*prev = BC_INST_MODEXP;
+	bc_parse_push(p, *prev);
+
+	return bc_lex_next(&p->l);
+}
+
 BcStatus bc_parse_scale(BcParse *p, BcInst *type, uint8_t flags) {
 
 	BcStatus s;
@@ -362,9 +392,7 @@ BcStatus bc_parse_minus(BcParse *p, BcInst *prev, size_t ops_bgn,
 	s = bc_lex_next(&p->l);
 	if (s) return s;
 
-	type = rparen || etype == BC_INST_INC_POST || etype == BC_INST_DEC_POST ||
-	       (etype >= BC_INST_NUM && etype <= BC_INST_SQRT) ?
-	                 BC_LEX_OP_MINUS : BC_LEX_NEG;
+	type = BC_PARSE_LEAF(etype, rparen) ? BC_LEX_OP_MINUS : BC_LEX_NEG;
 	*prev = BC_PARSE_TOKEN_INST(type);
 
 	// We can just push onto the op stack because this is the largest
@@ -972,6 +1000,7 @@ BcStatus bc_parse_stmt(BcParse *p) {
 		case BC_LEX_KEY_READ:
 		case BC_LEX_KEY_SCALE:
 		case BC_LEX_KEY_SQRT:
+		case BC_LEX_KEY_MODEXP:
 		{
 			s = bc_parse_expr(p, BC_PARSE_PRINT, bc_parse_next_expr);
 			break;
@@ -1258,6 +1287,18 @@ BcStatus bc_parse_expr(BcParse *p, uint8_t flags, BcParseNext next) {
 				break;
 			}
 
+			case BC_LEX_KEY_MODEXP:
+			{
+				if (BC_PARSE_LEAF(prev, rprn)) return BC_STATUS_PARSE_BAD_EXP;
+
+				s = bc_parse_modexp(p, flags, &prev);
+				paren_expr = true;
+				rprn = get_token = bin_last = false;
+				++nexprs;
+
+				break;
+			}
+
 			case BC_LEX_KEY_READ:
 			{
 				if (BC_PARSE_LEAF(prev, rprn)) return BC_STATUS_PARSE_BAD_EXP;
@@ -183,7 +183,7 @@ const char bc_inst_chars[] =
 #endif // NDEBUG
 
 #ifdef BC_ENABLED
-const BcLexKeyword bc_lex_kws[20] = {
+const BcLexKeyword bc_lex_kws[21] = {
 	BC_LEX_KW_ENTRY("auto", 4, true),
 	BC_LEX_KW_ENTRY("break", 5, true),
 	BC_LEX_KW_ENTRY("continue", 8, false),
@@ -204,6 +204,7 @@ const BcLexKeyword bc_lex_kws[20] = {
 	BC_LEX_KW_ENTRY("scale", 5, true),
 	BC_LEX_KW_ENTRY("sqrt", 4, true),
 	BC_LEX_KW_ENTRY("while", 5, true),
+	BC_LEX_KW_ENTRY("modexp", 6, false),
 };
 
 // This is an array that corresponds to token types. An entry is
@@ -214,7 +215,7 @@ const bool bc_parse_exprs[] = {
 	true, true, true, false, false, true, true, false, false, false, false,
 	false, false, false, true, true, false, false, false, false, false, false,
 	false, true, false, true, true, true, true, false, false, true, false, true,
-	true, false,
+	true, false, true,
 };
 
 // This is an array of data for operators that correspond to token types.
@@ -301,17 +302,27 @@ const BcInst dc_parse_insts[] = {
 	BC_INST_INVALID, BC_INST_INVALID, BC_INST_LENGTH, BC_INST_INVALID,
 	BC_INST_OBASE, BC_INST_PRINT, BC_INST_QUIT, BC_INST_INVALID,
 	BC_INST_INVALID, BC_INST_SCALE, BC_INST_SQRT, BC_INST_INVALID,
-	BC_INST_REL_EQ, BC_INST_MODEXP, BC_INST_DIVMOD, BC_INST_INVALID,
-	BC_INST_INVALID, BC_INST_EXECUTE, BC_INST_PRINT_STACK, BC_INST_CLEAR_STACK,
-	BC_INST_STACK_LEN, BC_INST_DUPLICATE, BC_INST_SWAP, BC_INST_POP,
-	BC_INST_ASCIIFY, BC_INST_PRINT_STREAM, BC_INST_INVALID, BC_INST_INVALID,
+	BC_INST_INVALID, BC_INST_REL_EQ, BC_INST_MODEXP, BC_INST_DIVMOD,
+	BC_INST_INVALID, BC_INST_INVALID, BC_INST_EXECUTE, BC_INST_PRINT_STACK,
+	BC_INST_CLEAR_STACK, BC_INST_STACK_LEN, BC_INST_DUPLICATE, BC_INST_SWAP,
+	BC_INST_POP, BC_INST_ASCIIFY, BC_INST_PRINT_STREAM, BC_INST_INVALID,
 	BC_INST_INVALID, BC_INST_INVALID, BC_INST_INVALID, BC_INST_INVALID,
-	BC_INST_PRINT, BC_INST_NQUIT, BC_INST_SCALE_FUNC,
+	BC_INST_INVALID, BC_INST_PRINT, BC_INST_NQUIT, BC_INST_SCALE_FUNC,
 };
 #endif // DC_ENABLED
 
 const char bc_num_hex_digits[] = "0123456789ABCDEF";
 
+const BcBigDig bc_num_pow10[BC_BASE_DIGS + 1] = {
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+const uint32_t bc_num_ntt_primes[BC_NUM_NTT_PRIMES] = {
+	2013265921, 469762049, 167772161,
+};
+
+const uint32_t bc_num_ntt_roots[BC_NUM_NTT_PRIMES] = { 31, 3, 3 };
+
 const BcNumBinaryOp bc_program_ops[] = {
 	bc_num_pow, bc_num_mul, bc_num_div, bc_num_mod, bc_num_add, bc_num_sub,
 };
@@ -37,9 +37,13 @@
 
 void bc_num_setToZero(BcNum *n, size_t scale) {
 	assert(n);
-	n->len = 0;
+	n->len = n->off = 0;
 	n->neg = false;
-	n->rdx = scale;
+	n->scale = scale;
+	n->rdx = BC_NUM_RDX(scale);
+#if BC_NUM_BINARY
+	n->bin = false;
+#endif // BC_NUM_BINARY
 }
 
 void bc_num_zero(BcNum *n) {
@@ -55,313 +59,1692 @@ void bc_num_one(BcNum *n) {
 void bc_num_ten(BcNum *n) {
 	assert(n);
 	bc_num_setToZero(n, 0);
-	n->len = 2;
-	n->num[0] = 0;
-	n->num[1] = 1;
+	n->len = 1;
+	n->num[0] = 10;
 }
 
-BcStatus bc_num_subArrays(BcDig *restrict a, BcDig *restrict b,size_t len) {
-	size_t i, j;
-	for (i = 0; !bcg.signe && i < len; ++i) {
-		for (a[i] -= b[i], j = 0; !bcg.signe && a[i + j] < 0;) {
-			a[i + j++] += 10;
-			a[i + j] -= 1;
-		}
-	}
-	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+size_t bc_num_digits(BcDig dig) {
+	size_t digits;
+	for (digits = 1; dig >= 10; dig /= 10, ++digits);
+	return digits;
 }
 
-ssize_t bc_num_compare(BcDig *restrict a, BcDig *restrict b, size_t len) {
+BcDig bc_num_digit(BcDig dig, size_t idx) {
+	return (dig / (BcDig) bc_num_pow10[idx]) % 10;
+}
+
+BcDig bc_num_limb(BcNum *n, size_t idx) {
+	return idx >= n->off && idx < BC_NUM_TOP(n) ? n->num[idx - n->off] : 0;
+}
+
+// Returns how many zeros there are after the radix of a nonzero number below 1.
+size_t bc_num_zeros(BcNum *n) {
+	return (n->rdx - BC_NUM_TOP(n)) * BC_BASE_DIGS + BC_BASE_DIGS -
+	       bc_num_digits(n->num[n->len - 1]);
+}
+
+size_t bc_num_intDigits(BcNum *n) {
+
 	size_t i;
-	int c = 0;
-	for (i = len - 1; !bcg.signe && i < len && !(c = a[i] - b[i]); --i);
-	return BC_NUM_NEG(i + 1, c < 0);
+
+	for (i = n->len; i > 0 && n->num[i - 1] == 0; --i);
+	if (i + n->off <= n->rdx) return 0;
+
+	return (i + n->off - n->rdx - 1) * BC_BASE_DIGS +
+	       bc_num_digits(n->num[i - 1]);
 }
 
-ssize_t bc_num_cmp(BcNum *a, BcNum *b) {
+// These work a block of limbs at a time. Each limb of a block is reduced on its
+// own, then the carries (or borrows) out of the limbs are added in a second
+// pass. Neither pass depends on the previous limb, so both can be vectorized.
+// A carry only goes further when it lands on a limb of BC_BASE_POW - 1 (and a
+// borrow on a limb of 0); a scalar pass fixes that up when it happens.
+BcDig bc_num_addArrays(BcDig *c, BcDig *a, BcDig *restrict b, size_t len) {
 
-	size_t i, min, a_int, b_int, diff;
-	BcDig *max_num, *min_num;
-	bool a_max, neg = false;
-	ssize_t cmp;
+	size_t i, j, n;
+	BcDig in, carry, fix, g[BC_NUM_BLOCK_LEN];
 
-	assert(a && b);
+	for (carry = 0, i = 0; !bcg.signe && i < len; i += n) {
 
-	if (a == b) return 0;
-	if (a->len == 0) return BC_NUM_NEG(!!b->len, !b->neg);
-	if (b->len == 0) return BC_NUM_NEG(1, a->neg);
-	if (a->neg) {
-		if (b->neg) neg = true;
-		else return -1;
-	}
-	else if (b->neg) return 1;
+		n = BC_MIN(len - i, BC_NUM_BLOCK_LEN);
 
-	a_int = BC_NUM_INT(a);
-	b_int = BC_NUM_INT(b);
-	a_int -= b_int;
-	a_max = (a->rdx > b->rdx);
+		for (j = 0; j < n; ++j) {
+			in = a[i + j] + b[i + j];
+			g[j] = in >= BC_BASE_POW;
+			c[i + j] = in - g[j] * BC_BASE_POW;
+		}
 
-	if (a_int != 0) return (ssize_t) a_int;
+		c[i] += carry;
+		fix = c[i] == BC_BASE_POW;
 
-	if (a_max) {
-		min = b->rdx;
-		diff = a->rdx - b->rdx;
-		max_num = a->num + diff;
-		min_num = b->num;
-	}
-	else {
-		min = a->rdx;
-		diff = b->rdx - a->rdx;
-		max_num = b->num + diff;
-		min_num = a->num;
-	}
+		for (j = 1; j < n; ++j) {
+			c[i + j] += g[j - 1];
+			fix |= c[i + j] == BC_BASE_POW;
+		}
 
-	cmp = bc_num_compare(max_num, min_num, b_int + min);
-	if (cmp != 0) return BC_NUM_NEG(cmp, (!a_max) != neg);
+		carry = g[n - 1];
 
-	for (max_num -= diff, i = diff - 1; !bcg.signe && i < diff; --i) {
-		if (max_num[i]) return BC_NUM_NEG(1, (!a_max) != neg);
+		for (j = 0; fix && j < n; ++j) {
+			if (c[i + j] != BC_BASE_POW) continue;
+			c[i + j] = 0;
+			if (j + 1 < n) c[i + j + 1] += 1;
+			else carry = 1;
+		}
 	}
 
-	return 0;
+	return carry;
 }
 
-void bc_num_truncate(BcNum *n, size_t places) {
-
-	assert(places <= n->rdx && (n->len == 0 || places <= n->len));
-
-	if (places == 0) return;
+void bc_num_addTo(BcDig *a, size_t alen, BcDig *restrict b, size_t blen) {
 
-	n->rdx -= places;
+	size_t i;
+	BcDig carry = bc_num_addArrays(a, a, b, blen);
 
-	if (n->len != 0) {
-		n->len -= places;
-		memmove(n->num, n->num + places, n->len * sizeof(BcDig));
+	for (i = blen; carry != 0 && i < alen; ++i) {
+		a[i] += carry;
+		carry = a[i] == BC_BASE_POW;
+		a[i] -= carry * BC_BASE_POW;
 	}
 }
 
-void bc_num_extend(BcNum *n, size_t places) {
+BcStatus bc_num_subArrays(BcDig *restrict a, BcDig *restrict b, size_t len) {
+
+	size_t i, j, n;
+	BcDig in, borrow, fix, g[BC_NUM_BLOCK_LEN];
+
+	for (borrow = 0, i = 0; !bcg.signe && i < len; i += n) {
 
-	size_t len = n->len + places;
+		n = BC_MIN(len - i, BC_NUM_BLOCK_LEN);
 
-	if (places != 0) {
+		for (j = 0; j < n; ++j) {
+			in = a[i + j] - b[i + j];
+			g[j] = in < 0;
+			a[i + j] = in + g[j] * BC_BASE_POW;
+		}
+
+		a[i] -= borrow;
+		fix = a[i] < 0;
+
+		for (j = 1; j < n; ++j) {
+			a[i + j] -= g[j - 1];
+			fix |= a[i + j] < 0;
+		}
+
+		borrow = g[n - 1];
+
+		for (j = 0; fix && j < n; ++j) {
+			if (a[i + j] >= 0) continue;
+			a[i + j] += BC_BASE_POW;
+			if (j + 1 < n) a[i + j + 1] -= 1;
+			else borrow = 1;
+		}
+	}
 
-		if (n->cap < len) bc_num_expand(n, len);
+	for (; !bcg.signe && borrow != 0; ++i) {
+		a[i] -= 1;
+		borrow = a[i] < 0;
+		a[i] += borrow * BC_BASE_POW;
+	}
 
-		memmove(n->num + places, n->num, sizeof(BcDig) * n->len);
-		memset(n->num, 0, sizeof(BcDig) * places);
+	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+}
 
-		n->len += places;
-		n->rdx += places;
+// Subtracts b * q from the len + 1 limbs of a, and returns the top limb of a,
+// which is negative if b * q was bigger.
+BcDig bc_num_mulSubArrays(BcDig *restrict a, BcDig *restrict b, size_t len,
+                          BcBigDig q)
+{
+	size_t i;
+	BcBigDig in, carry;
+
+	for (carry = 0, i = 0; i < len; ++i) {
+		in = ((BcBigDig) b[i]) * q + carry;
+		carry = in / BC_BASE_POW;
+		a[i] -= (BcDig) (in % BC_BASE_POW);
+		if (a[i] < 0) {
+			a[i] += BC_BASE_POW;
+			carry += 1;
+		}
 	}
+
+	a[len] -= (BcDig) carry;
+
+	return a[len];
+}
+
+ssize_t bc_num_compare(BcDig *restrict a, BcDig *restrict b, size_t len) {
+	size_t i;
+	BcDig c = 0;
+	for (i = len - 1; !bcg.signe && i < len && !(c = a[i] - b[i]); --i);
+	return BC_NUM_NEG(i + 1, c < 0);
 }
 
 void bc_num_clean(BcNum *n) {
+
+	size_t i;
+
 	while (n->len > 0 && n->num[n->len - 1] == 0) --n->len;
-	if (n->len == 0) n->neg = false;
-	else if (n->len < n->rdx) n->len = n->rdx;
+
+	if (n->len == 0) {
+		n->neg = false;
+		n->off = 0;
+	}
+	else if (n->num[0] == 0) {
+		for (i = 1; n->num[i] == 0; ++i);
+		n->len -= i;
+		n->off += i;
+		memmove(n->num, n->num + i, n->len * sizeof(BcDig));
+	}
 }
 
-void bc_num_retireMul(BcNum *n, size_t scale, bool neg1, bool neg2) {
+// Returns how many limbs (or words) of scratch space Karatsuba needs when the
+// longer number has len of them. Each level needs 4h + 4 for a split at h, and
+// the numbers passed down are no longer than h + 1, which is only shorter than
+// len from BC_NUM_KARATSUBA_MIN on.
+size_t bc_num_kScratch(size_t len) {
 
-	if (n->rdx < scale) bc_num_extend(n, scale - n->rdx);
-	else bc_num_truncate(n, n->rdx - scale);
+	size_t h, size;
 
-	bc_num_clean(n);
-	if (n->len != 0) n->neg = !neg1 != !neg2;
+	for (size = 0; len >= BC_NUM_KARATSUBA_LEN && len >= BC_NUM_KARATSUBA_MIN;
+	     len = h + 1)
+	{
+		h = (len + 1) / 2;
+		size += 4 * h + 4;
+	}
+
+	return size;
+}
+
+#if BC_NUM_BINARY
+size_t bc_num_binLen(BcBinDig *a, size_t len) {
+	while (len > 0 && a[len - 1] == 0) --len;
+	return len;
 }
 
-void bc_num_split(BcNum *restrict n, size_t idx, BcNum *restrict a,
-                  BcNum *restrict b)
+ssize_t bc_num_binCompare(BcBinDig *a, size_t alen, BcBinDig *b, size_t blen)
 {
-	if (idx < n->len) {
+	size_t i;
+	if (alen != blen) return BC_NUM_NEG(1, alen < blen);
+	for (i = alen - 1; i < alen && a[i] == b[i]; --i);
+	return i < alen ? BC_NUM_NEG(1, a[i] < b[i]) : 0;
+}
 
-		b->len = n->len - idx;
-		a->len = idx;
-		a->rdx = b->rdx = 0;
+void bc_num_binAddTo(BcBinDig *a, size_t alen, BcBinDig *b, size_t blen) {
 
-		memcpy(b->num, n->num + idx, b->len * sizeof(BcDig));
-		memcpy(a->num, n->num, idx * sizeof(BcDig));
+	size_t i;
+	BcBigDig carry;
+
+	for (carry = 0, i = 0; i < blen; ++i) {
+		carry += (BcBigDig) a[i] + b[i];
+		a[i] = (BcBinDig) carry;
+		carry >>= 32;
 	}
-	else {
-		bc_num_zero(b);
-		bc_num_copy(a, n);
+
+	for (; carry != 0 && i < alen; ++i) {
+		carry += a[i];
+		a[i] = (BcBinDig) carry;
+		carry >>= 32;
+	}
+}
+
+void bc_num_binSubFrom(BcBinDig *a, size_t alen, BcBinDig *b, size_t blen) {
+
+	size_t i;
+	BcBigDig in, borrow;
+
+	for (borrow = 0, i = 0; i < blen; ++i) {
+		in = (BcBigDig) a[i] - b[i] - borrow;
+		a[i] = (BcBinDig) in;
+		borrow = in >> 63;
 	}
 
-	bc_num_clean(a);
-	bc_num_clean(b);
+	for (; borrow != 0 && i < alen; ++i) {
+		in = (BcBigDig) a[i] - borrow;
+		a[i] = (BcBinDig) in;
+		borrow = in >> 63;
+	}
 }
 
-BcStatus bc_num_shift(BcNum *n, size_t places) {
+size_t bc_num_binMulAdd(BcBinDig *a, size_t len, BcBinDig mul, BcBinDig add) {
 
-	if (places == 0 || n->len == 0) return BC_STATUS_SUCCESS;
-	if (places + n->len > BC_MAX_NUM) return BC_STATUS_EXEC_NUM_LEN;
+	size_t i;
+	BcBigDig carry;
 
-	if (n->rdx >= places) n->rdx -= places;
-	else {
-		bc_num_extend(n, places - n->rdx);
-		n->rdx = 0;
+	for (carry = add, i = 0; i < len; ++i) {
+		carry += (BcBigDig) a[i] * mul;
+		a[i] = (BcBinDig) carry;
+		carry >>= 32;
 	}
 
-	bc_num_clean(n);
+	if (carry != 0) a[len++] = (BcBinDig) carry;
 
-	return BC_STATUS_SUCCESS;
+	return len;
 }
 
-BcStatus bc_num_inv(BcNum *a, BcNum *b, size_t scale) {
+BcBinDig bc_num_binDivWord(BcBinDig *a, size_t len, BcBinDig div) {
 
-	BcNum one;
-	BcDig num[2];
+	size_t i;
+	BcBigDig rem;
 
-	one.cap = 2;
-	one.num = num;
-	bc_num_one(&one);
+	for (rem = 0, i = len - 1; i < len; --i) {
+		rem = (rem << 32) | a[i];
+		a[i] = (BcBinDig) (rem / div);
+		rem %= div;
+	}
 
-	return bc_num_div(&one, a, b, scale);
+	return (BcBinDig) rem;
 }
 
-BcStatus bc_num_a(BcNum *a, BcNum *b, BcNum *restrict c, size_t sub) {
+// Squares a schoolbook way: the products a[i] * a[j] with i < j are summed,
+// doubled with a shift, and then the squares a[i] * a[i] are added.
+void bc_num_binSqr(BcBinDig *restrict c, BcBinDig *restrict a, size_t len) {
 
-	BcDig *ptr, *ptr_a, *ptr_b, *ptr_c;
-	size_t i, max, min_rdx, min_int, diff, a_int, b_int;
-	int carry, in;
+	BcBigDig carry;
+	BcBinDig top;
+	size_t i, j;
 
-	// Because this function doesn't need to use scale (per the bc spec),
-	// I am hijacking it to say whether it's doing an add or a subtract.
+	memset(c, 0, 2 * len * sizeof(BcBinDig));
 
-	if (a->len == 0) {
-		bc_num_copy(c, b);
-		if (sub && c->len) c->neg = !c->neg;
-		return BC_STATUS_SUCCESS;
+	for (i = 0; !bcg.signe && i < len; ++i) {
+
+		for (carry = 0, j = i + 1; j < len; ++j) {
+			carry += (BcBigDig) a[i] * a[j] + c[i + j];
+			c[i + j] = (BcBinDig) carry;
+			carry >>= 32;
+		}
+
+		c[i + len] = (BcBinDig) carry;
 	}
-	else if (b->len == 0) {
-		bc_num_copy(c, a);
-		return BC_STATUS_SUCCESS;
+
+	for (top = 0, i = 0; i < 2 * len; ++i) {
+		carry = c[i];
+		c[i] = (BcBinDig) (carry << 1) | top;
+		top = (BcBinDig) (carry >> 31);
 	}
 
-	c->neg = a->neg;
-	c->rdx = BC_MAX(a->rdx, b->rdx);
-	min_rdx = BC_MIN(a->rdx, b->rdx);
-	c->len = 0;
+	for (carry = 0, i = 0; i < len; ++i) {
+		carry += (BcBigDig) a[i] * a[i] + c[2 * i];
+		c[2 * i] = (BcBinDig) carry;
+		carry = (carry >> 32) + c[2 * i + 1];
+		c[2 * i + 1] = (BcBinDig) carry;
+		carry >>= 32;
+	}
+}
 
-	if (a->rdx > b->rdx) {
-		diff = a->rdx - b->rdx;
-		ptr = a->num;
-		ptr_a = a->num + diff;
-		ptr_b = b->num;
+void bc_num_binK(BcBinDig *restrict c, BcBinDig *a, size_t alen,
+                 BcBinDig *b, size_t blen, BcBinDig *scratch)
+{
+	BcBinDig *ptr;
+	BcBigDig carry;
+	size_t i, j, h, len1, len2;
+
+	if (alen < blen) {
+		ptr = a;
+		a = b;
+		b = ptr;
+		i = alen;
+		alen = blen;
+		blen = i;
 	}
-	else {
-		diff = b->rdx - a->rdx;
-		ptr = b->num;
-		ptr_a = a->num;
-		ptr_b = b->num + diff;
+
+	if (blen < BC_NUM_KARATSUBA_LEN || alen < BC_NUM_KARATSUBA_MIN) {
+
+		if (a == b && alen == blen) {
+			bc_num_binSqr(c, a, alen);
+			return;
+		}
+
+		memset(c, 0, (alen + blen) * sizeof(BcBinDig));
+
+		for (i = 0; !bcg.signe && i < blen; ++i) {
+
+			for (carry = 0, j = 0; j < alen; ++j) {
+				carry += (BcBigDig) a[j] * b[i] + c[i + j];
+				c[i + j] = (BcBinDig) carry;
+				carry >>= 32;
+			}
+
+			c[i + alen] = (BcBinDig) carry;
+		}
+
+		return;
+	}
+
+	h = (alen + 1) / 2;
+	ptr = scratch + 4 * h + 4;
+
+	// If b is no longer than the low half of a, only a is split.
+	if (blen <= h) {
+
+		bc_num_binK(c, a, h, b, blen, ptr);
+		bc_num_binK(scratch, a + h, alen - h, b, blen, ptr);
+
+		memset(c + h + blen, 0, (alen - h) * sizeof(BcBinDig));
+		bc_num_binAddTo(c + h, alen + blen - h, scratch, alen - h + blen);
+
+		return;
 	}
 
-	for (ptr_c = c->num, i = 0; i < diff; ++i, ++c->len) ptr_c[i] = ptr[i];
+	bc_num_binK(c, a, h, b, h, ptr);
+	bc_num_binK(c + 2 * h, a + h, alen - h, b + h, blen - h, ptr);
 
-	ptr_c += diff;
-	a_int = BC_NUM_INT(a);
-	b_int = BC_NUM_INT(b);
+	memcpy(scratch, a, h * sizeof(BcBinDig));
+	scratch[h] = 0;
+	bc_num_binAddTo(scratch, h + 1, a + h, alen - h);
+	len1 = bc_num_binLen(scratch, h + 1);
 
-	if (a_int > b_int) {
-		min_int = b_int;
-		max = a_int;
-		ptr = ptr_a;
+	if (a == b && alen == blen) {
+		b = scratch;
+		len2 = len1;
 	}
 	else {
-		min_int = a_int;
-		max = b_int;
-		ptr = ptr_b;
+		memcpy(scratch + h + 1, b, h * sizeof(BcBinDig));
+		scratch[2 * h + 1] = 0;
+		bc_num_binAddTo(scratch + h + 1, h + 1, b + h, blen - h);
+		b = scratch + h + 1;
+		len2 = bc_num_binLen(b, h + 1);
+	}
+
+	bc_num_binK(scratch + 2 * h + 2, scratch, len1, b, len2, ptr);
+	ptr = scratch + 2 * h + 2;
+
+	i = bc_num_binLen(c, 2 * h);
+	bc_num_binSubFrom(ptr, len1 + len2, c, i);
+	i = bc_num_binLen(c + 2 * h, alen + blen - 2 * h);
+	bc_num_binSubFrom(ptr, len1 + len2, c + 2 * h, i);
+	len1 = bc_num_binLen(ptr, len1 + len2);
+
+	bc_num_binAddTo(c + h, alen + blen - h, ptr, len1);
+}
+
+// This is Knuth's Algorithm D. The quotient has alen - blen + 1 words and the
+// remainder blen words; either of them can be NULL if it is not needed.
+void bc_num_binDivArrays(BcBinDig *a, size_t alen, BcBinDig *b, size_t blen,
+                         BcBinDig *q, BcBinDig *r)
+{
+	BcBinDig *u, *v;
+	BcBigDig num, qhat, rhat, prod, in, carry, borrow;
+	size_t i, j, shift;
+
+	assert(alen >= blen && blen != 0 && b[blen - 1] != 0);
+
+	if (blen == 1) {
+
+		for (rhat = 0, i = alen - 1; i < alen; --i) {
+			rhat = (rhat << 32) | a[i];
+			if (q) q[i] = (BcBinDig) (rhat / b[0]);
+			rhat %= b[0];
+		}
+
+		if (r) r[0] = (BcBinDig) rhat;
+
+		return;
 	}
 
-	for (carry = 0, i = 0; !bcg.signe && i < min_rdx + min_int; ++i, ++c->len) {
-		in = ((int) ptr_a[i]) + ((int) ptr_b[i]) + carry;
-		carry = in / 10;
-		ptr_c[i] = (BcDig) (in % 10);
+	// Normalize so the top bit of the divisor is set.
+	for (shift = 0; !((b[blen - 1] << shift) & 0x80000000); ++shift);
+
+	u = bc_vm_malloc((alen + blen + 1) * sizeof(BcBinDig));
+	v = u + alen + 1;
+
+	for (carry = 0, i = 0; i < alen; ++i) {
+		in = ((BcBigDig) a[i]) << shift | carry;
+		u[i] = (BcBinDig) in;
+		carry = in >> 32;
 	}
 
-	for (; !bcg.signe && i < max + min_rdx; ++i, ++c->len) {
-		in = ((int) ptr[i]) + carry;
-		carry = in / 10;
-		ptr_c[i] = (BcDig) (in % 10);
+	u[alen] = (BcBinDig) carry;
+
+	for (carry = 0, i = 0; i < blen; ++i) {
+		in = ((BcBigDig) b[i]) << shift | carry;
+		v[i] = (BcBinDig) in;
+		carry = in >> 32;
 	}
 
-	if (carry != 0) c->num[c->len++] = (BcDig) carry;
+	for (j = alen - blen; !bcg.signe && j <= alen - blen; --j) {
 
-	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
-}
+		num = ((BcBigDig) u[j + blen]) << 32 | u[j + blen - 1];
+		qhat = num / v[blen - 1];
+		rhat = num % v[blen - 1];
 
-BcStatus bc_num_s(BcNum *a, BcNum *b, BcNum *restrict c, size_t sub) {
+		while (qhat >> 32 ||
+		       qhat * v[blen - 2] > (rhat << 32 | u[j + blen - 2]))
+		{
+			qhat -= 1;
+			rhat += v[blen - 1];
+			if (rhat >> 32) break;
+		}
 
-	BcStatus s;
-	ssize_t cmp;
-	BcNum *minuend, *subtrahend;
-	size_t start;
-	bool aneg, bneg, neg;
+		for (carry = borrow = 0, i = 0; i < blen; ++i) {
+			prod = qhat * v[i] + carry;
+			carry = prod >> 32;
+			in = (BcBigDig) u[i + j] - (BcBinDig) prod - borrow;
+			u[i + j] = (BcBinDig) in;
+			borrow = in >> 63;
+		}
 
-	// Because this function doesn't need to use scale (per the bc spec),
-	// I am hijacking it to say whether it's doing an add or a subtract.
+		in = (BcBigDig) u[j + blen] - carry - borrow;
+		u[j + blen] = (BcBinDig) in;
 
-	if (a->len == 0) {
-		bc_num_copy(c, b);
-		if (sub && c->len) c->neg = !c->neg;
-		return BC_STATUS_SUCCESS;
+		// The estimate was one too large, so add back one divisor.
+		if (in >> 63) {
+			qhat -= 1;
+			u[j + blen] = 0;
+			bc_num_binAddTo(u + j, blen, v, blen);
+		}
+
+		if (q) q[j] = (BcBinDig) qhat;
 	}
-	else if (b->len == 0) {
-		bc_num_copy(c, a);
-		return BC_STATUS_SUCCESS;
+
+	if (r) {
+		for (i = 0; i < blen; ++i) {
+			in = ((BcBigDig) u[i + 1]) << 32 | u[i];
+			r[i] = (BcBinDig) (in >> shift);
+		}
 	}
 
-	aneg = a->neg;
-	bneg = b->neg;
-	a->neg = b->neg = false;
+	free(u);
+}
 
-	cmp = bc_num_cmp(a, b);
+void bc_num_binRetire(BcNum *n, size_t len, bool neg) {
+	n->len = bc_num_binLen((BcBinDig*) n->num, len);
+	n->rdx = n->scale = n->off = 0;
+	n->bin = n->len != 0;
+	n->neg = n->bin && neg;
+}
 
-	a->neg = aneg;
-	b->neg = bneg;
+// Converts the len decimal limbs in d to binary in w, which needs room for
+// len + 1 words, and returns the number of words. Longer runs are split at
+// limb 2^i, where pows[i] holds 10^(BC_BASE_DIGS * 2^i) in binary, so that the
+// conversion costs a few multiplications rather than len^2 word operations.
+size_t bc_num_binConv(BcBinDig *w, BcDig *d, size_t len, BcVec *pows,
+                      size_t i, BcBinDig *scratch)
+{
+	BcBinDig *hi, *prod;
+	BcNum *p;
+	size_t h, j, hlen, plen;
+
+	if (len <= BC_NUM_BIN_LEN) {
+		for (plen = 0, j = len - 1; j < len; --j)
+			plen = bc_num_binMulAdd(w, plen, BC_BASE_POW, (BcBinDig) d[j]);
+		return plen;
+	}
 
-	if (cmp == 0) {
-		bc_num_setToZero(c, BC_MAX(a->rdx, b->rdx));
-		return BC_STATUS_SUCCESS;
+	for (h = ((size_t) 1) << i; h >= len; h >>= 1) --i;
+
+	p = bc_vec_item(pows, i);
+	hi = bc_vm_malloc((2 * len + 1) * sizeof(BcBinDig));
+	prod = hi + len - h + 1;
+
+	hlen = bc_num_binConv(hi, d + h, len - h, pows, i - 1, scratch);
+	plen = bc_num_binConv(w, d, h, pows, i - 1, scratch);
+	memset(w + plen, 0, (len + 1 - plen) * sizeof(BcBinDig));
+
+	// The low half is less than pows[i], so neither part is longer than len.
+	if (hlen != 0) {
+		bc_num_binK(prod, hi, hlen, (BcBinDig*) p->num, p->len, scratch);
+		bc_num_binAddTo(w, len + 1, prod, hlen + p->len);
 	}
-	else if (cmp > 0) {
-		neg = a->neg;
-		minuend = a;
-		subtrahend = b;
+
+	free(hi);
+
+	return bc_num_binLen(w, len);
+}
+
+void bc_num_toBin(BcNum *n) {
+
+	BcBinDig *w, *scratch = NULL;
+	BcDig *d;
+	BcNum pow, *p;
+	BcVec pows;
+	size_t i, len, top, cap;
+
+	if (n->bin || n->len == 0) return;
+
+	assert(n->scale == 0);
+
+	n->bin = true;
+
+	// A single limb is the same number in binary.
+	if (n->len == 1 && n->off == 0) return;
+
+	top = BC_NUM_TOP(n);
+	cap = BC_MAX(top + 1, BC_NUM_DEF_SIZE);
+	w = bc_vm_malloc(cap * sizeof(BcBinDig));
+
+	if (top <= BC_NUM_BIN_LEN) {
+		for (len = 0, i = n->len - 1; i < n->len; --i)
+			len = bc_num_binMulAdd(w, len, BC_BASE_POW, (BcBinDig) n->num[i]);
+		for (i = 0; i < n->off; ++i)
+			len = bc_num_binMulAdd(w, len, BC_BASE_POW, 0);
 	}
 	else {
-		neg = b->neg;
-		if (sub) neg = !neg;
-		minuend = b;
-		subtrahend = a;
+
+		d = bc_vm_malloc(top * sizeof(BcDig));
+		memset(d, 0, n->off * sizeof(BcDig));
+		memcpy(d + n->off, n->num, n->len * sizeof(BcDig));
+
+		bc_vec_init(&pows, sizeof(BcNum), bc_num_free);
+		bc_num_init(&pow, BC_NUM_DEF_SIZE);
+		((BcBinDig*) pow.num)[0] = BC_BASE_POW;
+		bc_num_binRetire(&pow, 1, false);
+		bc_vec_push(&pows, &pow);
+
+		len = bc_num_kScratch(top);
+		if (len != 0) scratch = bc_vm_malloc(len * sizeof(BcBinDig));
+
+		for (i = 0, p = bc_vec_item(&pows, 0); (((size_t) 2) << i) < top; ++i) {
+			bc_num_init(&pow, 2 * p->len);
+			bc_num_binK((BcBinDig*) pow.num, (BcBinDig*) p->num, p->len,
+			            (BcBinDig*) p->num, p->len, scratch);
+			bc_num_binRetire(&pow, 2 * p->len, false);
+			bc_vec_push(&pows, &pow);
+			p = bc_vec_item(&pows, i + 1);
+		}
+
+		len = bc_num_binConv(w, d, top, &pows, i, scratch);
+
+		free(scratch);
+		bc_vec_free(&pows);
+		free(d);
 	}
 
-	bc_num_copy(c, minuend);
-	c->neg = neg;
+	free(n->num);
+	n->num = (BcDig*) w;
+	n->cap = cap;
+	n->len = len;
+	n->off = 0;
+}
+
+// Sets the magnitude of n to the len binary words in w, a limb at a time.
+void bc_num_decWords(BcNum *n, BcBinDig *w, size_t len) {
 
-	if (c->rdx < subtrahend->rdx) {
-		bc_num_extend(c, subtrahend->rdx - c->rdx);
-		start = 0;
+	BcBinDig *t;
+	size_t i;
+
+	t = bc_vm_malloc((len + 1) * sizeof(BcBinDig));
+	memcpy(t, w, len * sizeof(BcBinDig));
+
+	// Each limb holds more than 29 bits.
+	bc_num_expand(n, len + len / 8 + 1);
+
+	for (i = 0; len != 0; ++i) {
+		n->num[i] = (BcDig) bc_num_binDivWord(t, len, BC_BASE_POW);
+		len = bc_num_binLen(t, len);
 	}
-	else start = c->rdx - subtrahend->rdx;
 
-	s = bc_num_subArrays(c->num + start, subtrahend->num, subtrahend->len);
+	n->len = i;
+	n->off = 0;
+	bc_num_clean(n);
 
-	bc_num_clean(c);
+	free(t);
+}
+
+// Sets n to the len binary words in w in decimal. Like bc_num_binConv(), it
+// splits longer runs at word 2^i, where pows[i] holds 2^(32 * 2^i) in decimal.
+BcStatus bc_num_decConv(BcNum *n, BcBinDig *w, size_t len, BcVec *pows,
+                        size_t i)
+{
+	BcStatus s;
+	BcNum lo, hi, t;
+	size_t h;
+
+	len = bc_num_binLen(w, len);
+
+	if (len <= BC_NUM_BIN_LEN) {
+		bc_num_decWords(n, w, len);
+		return BC_STATUS_SUCCESS;
+	}
+
+	for (h = ((size_t) 1) << i; h >= len; h >>= 1) --i;
+
+	bc_num_init(&lo, BC_NUM_DEF_SIZE);
+	bc_num_init(&hi, BC_NUM_DEF_SIZE);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
 
+	s = bc_num_decConv(&lo, w, h, pows, i - 1);
+	if (s) goto err;
+	s = bc_num_decConv(&hi, w + h, len - h, pows, i - 1);
+	if (s) goto err;
+	s = bc_num_mul(&hi, bc_vec_item(pows, i), &t, 0);
+	if (s) goto err;
+	s = bc_num_add(&t, &lo, n, 0);
+
+err:
+	bc_num_free(&t);
+	bc_num_free(&hi);
+	bc_num_free(&lo);
 	return s;
 }
 
-BcStatus bc_num_k(BcNum *restrict a, BcNum *restrict b, BcNum *restrict c) {
+void bc_num_toDec(BcNum *n) {
 
 	BcStatus s;
-	int carry;
-	size_t i, j, len, max = BC_MAX(a->len, b->len), max2 = (max + 1) / 2;
-	BcNum l1, h1, l2, h2, m2, m1, z0, z1, z2, temp;
-	bool aone = BC_NUM_ONE(a);
+	BcBinDig *w;
+	BcNum pow, *p;
+	BcVec pows;
+	size_t i, len;
+	bool neg;
 
-	if (bcg.signe) return BC_STATUS_EXEC_SIGNAL;
+	if (!n->bin) return;
+
+	n->bin = false;
+
+	if (n->len == 1 && ((BcBinDig*) n->num)[0] < BC_BASE_POW) return;
+
+	len = n->len;
+
+	if (len <= BC_NUM_BIN_LEN) {
+		bc_num_decWords(n, (BcBinDig*) n->num, len);
+		return;
+	}
+
+	neg = n->neg;
+	w = bc_vm_malloc(len * sizeof(BcBinDig));
+	memcpy(w, n->num, len * sizeof(BcBinDig));
+
+	bc_vec_init(&pows, sizeof(BcNum), bc_num_free);
+	bc_num_init(&pow, BC_NUM_DEF_SIZE);
+	bc_vec_push(&pows, &pow);
+
+	// pows[0] is 2^32, which may not fit in an unsigned long.
+	bc_num_init(&pow, BC_NUM_DEF_SIZE);
+	s = bc_num_ulong2num(&pow, 1UL << 16);
+	if (!s) s = bc_num_mul(&pow, &pow, bc_vec_item(&pows, 0), 0);
+	bc_num_free(&pow);
+
+	for (i = 0, p = bc_vec_item(&pows, 0);
+	     !s && (((size_t) 2) << i) < len; ++i)
+	{
+		bc_num_init(&pow, 2 * p->len);
+		s = bc_num_mul(p, p, &pow, 0);
+		bc_vec_push(&pows, &pow);
+		p = bc_vec_item(&pows, i + 1);
+	}
+
+	// A signal leaves n zero, and the caller stops on it.
+	if (!s) s = bc_num_decConv(n, w, len, &pows, i);
+	if (s) bc_num_zero(n);
+	else n->neg = neg;
+
+	bc_vec_free(&pows);
+	free(w);
+}
+
+// Returns true if the operation should be done in binary. That is when it only
+// deals in integers and one of them is already binary; otherwise, everything
+// is made decimal.
+bool bc_num_useBin(BcNum *a, BcNum *b, bool ints) {
+
+	if (ints && (a->bin || b->bin)) {
+		bc_num_toBin(a);
+		bc_num_toBin(b);
+		return true;
+	}
+
+	bc_num_toDec(a);
+	bc_num_toDec(b);
+
+	return false;
+}
+#endif // BC_NUM_BINARY
+
+size_t bc_num_len(BcNum *n) {
+
+	size_t zeros;
+
+#if BC_NUM_BINARY
+	bc_num_toDec(n);
+#endif // BC_NUM_BINARY
+
+	if (n->len == 0) return 0;
+	if (BC_NUM_TOP(n) > n->rdx) return bc_num_intDigits(n) + n->scale;
+
+	zeros = bc_num_zeros(n);
+
+	return zeros < n->scale ? n->scale - zeros : 0;
+}
+
+ssize_t bc_num_cmp(BcNum *a, BcNum *b) {
+
+	size_t i, min, a_int, b_int, diff, dig, max_lo, max_hi, min_lo, min_hi;
+	BcNum *max_num, *min_num;
+	BcDig x, y;
+	bool a_max, neg = false;
+#if BC_NUM_BINARY
+	ssize_t cmp;
+#endif // BC_NUM_BINARY
+
+	assert(a && b);
+
+	if (a == b) return 0;
+	if (a->len == 0) return BC_NUM_NEG(!!b->len, !b->neg);
+	if (b->len == 0) return BC_NUM_NEG(1, a->neg);
+	if (a->neg) {
+		if (b->neg) neg = true;
+		else return -1;
+	}
+	else if (b->neg) return 1;
+
+#if BC_NUM_BINARY
+	if (bc_num_useBin(a, b, !a->scale && !b->scale)) {
+		cmp = bc_num_binCompare((BcBinDig*) a->num, a->len,
+		                        (BcBinDig*) b->num, b->len);
+		return neg ? -cmp : cmp;
+	}
+#endif // BC_NUM_BINARY
+
+	// The magnitude of the result is in decimal digits, as sqrt depends on it.
+	a_int = bc_num_intDigits(a);
+	b_int = bc_num_intDigits(b);
+	a_int -= b_int;
+	a_max = (a->scale > b->scale);
+
+	if (a_int != 0) return (ssize_t) a_int;
+
+	max_num = a_max ? a : b;
+	min_num = a_max ? b : a;
+
+	// Limb positions are counted from the lowest limb of max_num.
+	diff = max_num->rdx - min_num->rdx;
+	max_lo = max_num->off;
+	max_hi = BC_NUM_TOP(max_num);
+	min_lo = diff + min_num->off;
+	min_hi = diff + BC_NUM_TOP(min_num);
+
+	for (i = BC_MAX(max_hi, min_hi), x = y = 0; !bcg.signe && x == y;) {
+
+		// Runs of limbs that neither number stores are skipped.
+		if (i <= max_lo && i > min_hi) i = min_hi;
+		else if (i <= min_lo && i > max_hi) i = max_hi;
+
+		if (i <= diff || (i <= max_lo && i <= min_lo)) break;
+
+		i -= 1;
+		x = bc_num_limb(max_num, i);
+		y = bc_num_limb(min_num, i - diff);
+	}
+
+	if (x != y) {
+
+		for (dig = BC_BASE_DIGS - 1;
+		     dig && bc_num_digit(x, dig) == bc_num_digit(y, dig); --dig);
+
+		// Convert to the position in the digits both numbers have.
+		i = (i - diff) * BC_BASE_DIGS + dig;
+		min = min_num->rdx * BC_BASE_DIGS - min_num->scale;
+		i = i >= min ? i - min + 1 : 1;
+
+		return BC_NUM_NEG(BC_NUM_NEG(i, x < y), (!a_max) != neg);
+	}
+
+	if (!bcg.signe && max_lo < diff) return BC_NUM_NEG(1, (!a_max) != neg);
+
+	return 0;
+}
+
+void bc_num_truncate(BcNum *n, size_t places) {
+
+	size_t places_rdx, pow;
+
+	assert(places <= n->scale);
+
+	if (places == 0) return;
+
+	places_rdx = n->rdx - BC_NUM_RDX(n->scale - places);
+	n->scale -= places;
+	n->rdx -= places_rdx;
+
+	if (n->len == 0) return;
+
+	if (places_rdx <= n->off) n->off -= places_rdx;
+	else {
+
+		places_rdx -= n->off;
+		n->off = 0;
+
+		if (places_rdx >= n->len) {
+			bc_num_setToZero(n, n->scale);
+			return;
+		}
+
+		n->len -= places_rdx;
+		memmove(n->num, n->num + places_rdx, n->len * sizeof(BcDig));
+	}
+
+	pow = n->scale % BC_BASE_DIGS;
+	if (pow && n->off == 0) {
+		pow = bc_num_pow10[BC_BASE_DIGS - pow];
+		n->num[0] -= n->num[0] % (BcDig) pow;
+	}
+
+	bc_num_clean(n);
+}
+
+void bc_num_extend(BcNum *n, size_t places) {
+
+	size_t places_rdx;
+
+	if (places == 0) return;
+
+	places_rdx = BC_NUM_RDX(n->scale + places) - n->rdx;
+
+	if (n->len != 0) n->off += places_rdx;
+
+	n->rdx += places_rdx;
+	n->scale += places;
+}
+
+void bc_num_retireMul(BcNum *n, size_t scale, bool neg1, bool neg2) {
+
+	if (n->scale < scale) bc_num_extend(n, scale - n->scale);
+	else bc_num_truncate(n, n->scale - scale);
+
+	bc_num_clean(n);
+	if (n->len != 0) n->neg = !neg1 != !neg2;
+}
+
+void bc_num_mulWord(BcNum *n, BcBigDig w) {
+
+	size_t i;
+	BcBigDig in, carry;
+
+	if (w == 1 || n->len == 0) return;
+
+	bc_num_expand(n, n->len + 1);
+
+	for (carry = 0, i = 0; i < n->len; ++i) {
+		in = ((BcBigDig) n->num[i]) * w + carry;
+		carry = in / BC_BASE_POW;
+		n->num[i] = (BcDig) (in % BC_BASE_POW);
+	}
+
+	if (carry != 0) n->num[n->len++] = (BcDig) carry;
+
+	bc_num_clean(n);
+}
+
+// w has to divide n exactly, and it has to either divide BC_BASE_POW or have
+// no factor in common with it; then one of the off limbs is always enough for
+// the division to come out even.
+void bc_num_divWord(BcNum *n, BcBigDig w) {
+
+	size_t i;
+	BcBigDig rem;
+
+	if (w == 1 || n->len == 0) return;
+
+	if (n->off != 0) {
+		bc_num_expand(n, n->len + 1);
+		memmove(n->num + 1, n->num, n->len * sizeof(BcDig));
+		n->num[0] = 0;
+		n->len += 1;
+		n->off -= 1;
+	}
+
+	for (rem = 0, i = n->len - 1; i < n->len; --i) {
+		rem = rem * BC_BASE_POW + (BcBigDig) n->num[i];
+		n->num[i] = (BcDig) (rem / w);
+		rem %= w;
+	}
+
+	assert(rem == 0);
+
+	bc_num_clean(n);
+}
+
+BcStatus bc_num_shift(BcNum *n, size_t places) {
+
+	size_t scale, rdx, dig, limbs;
+	BcBigDig pow;
+	bool down;
+
+	if (places == 0 || n->len == 0) return BC_STATUS_SUCCESS;
+	if (places + BC_NUM_TOP(n) * BC_BASE_DIGS > BC_MAX_NUM)
+		return BC_STATUS_EXEC_NUM_LEN;
+
+	scale = n->scale > places ? n->scale - places : 0;
+	rdx = BC_NUM_RDX(scale);
+	dig = (n->rdx - rdx) * BC_BASE_DIGS;
+
+	// The limbs have to stay aligned on the radix, so moving it by anything
+	// other than whole limbs also moves the digits within the limbs. Moving
+	// digits down is done by moving them up and then dropping one more limb.
+	down = places < dig;
+
+	if (!down) {
+		places -= dig;
+		limbs = places / BC_BASE_DIGS;
+		pow = bc_num_pow10[places % BC_BASE_DIGS];
+	}
+	else {
+		places = dig - places;
+		limbs = BC_NUM_RDX(places);
+		pow = bc_num_pow10[limbs * BC_BASE_DIGS - places];
+	}
+
+	bc_num_mulWord(n, pow);
+
+	n->rdx = rdx;
+	n->scale = scale;
+
+	bc_num_clean(n);
+
+	// Whole limbs only move off. Everything shifted out is zero since it is
+	// below the scale, so it is never stored.
+	if (!down) n->off += limbs;
+	else {
+		assert(limbs <= n->off);
+		n->off -= limbs;
+	}
+
+	return BC_STATUS_SUCCESS;
+}
+
+BcStatus bc_num_inv(BcNum *a, BcNum *b, size_t scale) {
+
+	BcNum one;
+	BcDig num[2];
+
+	one.cap = 2;
+	one.num = num;
+	bc_num_one(&one);
+
+	return bc_num_div(&one, a, b, scale);
+}
+
+BcStatus bc_num_a(BcNum *a, BcNum *b, BcNum *restrict c, size_t sub) {
+
+	BcDig *ptr, *ptr_a, *ptr_c;
+	size_t i, min, max, a_lo, a_hi, b_lo, b_hi;
+	BcDig carry, in;
+	BcNum *temp;
+
+	// Because this function doesn't need to use scale (per the bc spec),
+	// I am hijacking it to say whether it's doing an add or a subtract.
+
+	if (a->len == 0) {
+		bc_num_copy(c, b);
+		if (sub && c->len) c->neg = !c->neg;
+		return BC_STATUS_SUCCESS;
+	}
+	else if (b->len == 0) {
+		bc_num_copy(c, a);
+		return BC_STATUS_SUCCESS;
+	}
+
+	c->neg = a->neg;
+	c->rdx = BC_MAX(a->rdx, b->rdx);
+	c->scale = BC_MAX(a->scale, b->scale);
+
+	// Limb positions are counted from the lowest limb of c, and a is made the
+	// one whose stored limbs start lower.
+	a_lo = c->rdx - a->rdx + a->off;
+	b_lo = c->rdx - b->rdx + b->off;
+
+	if (a_lo > b_lo) {
+		temp = a;
+		a = b;
+		b = temp;
+		i = a_lo;
+		a_lo = b_lo;
+		b_lo = i;
+	}
+
+	a_hi = a_lo + a->len;
+	b_hi = b_lo + b->len;
+
+	bc_num_expand(c, BC_MAX(a_hi, b_hi) - a_lo + 1);
+	c->off = a_lo;
+
+	min = BC_MIN(a_hi, b_lo) - a_lo;
+	memcpy(c->num, a->num, min * sizeof(BcDig));
+
+	if (a_hi <= b_lo) {
+		memset(c->num + min, 0, (b_lo - a_hi) * sizeof(BcDig));
+		memcpy(c->num + b_lo - a_lo, b->num, b->len * sizeof(BcDig));
+		c->len = b_hi - a_lo;
+		return BC_STATUS_SUCCESS;
+	}
+
+	ptr_a = a->num + min;
+	ptr_c = c->num + min;
+	ptr = a_hi > b_hi ? ptr_a : b->num;
+	max = BC_MAX(a_hi, b_hi) - b_lo;
+	min = BC_MIN(a_hi, b_hi) - b_lo;
+
+	carry = bc_num_addArrays(ptr_c, ptr_a, b->num, min);
+
+	for (i = min; carry != 0 && i < max; ++i) {
+		in = ptr[i] + carry;
+		carry = in >= BC_BASE_POW;
+		ptr_c[i] = in - carry * BC_BASE_POW;
+	}
+
+	memcpy(ptr_c + i, ptr + i, (max - i) * sizeof(BcDig));
+
+	c->len = b_lo - a_lo + max;
+	if (carry != 0) c->num[c->len++] = carry;
+
+	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+}
+
+BcStatus bc_num_s(BcNum *a, BcNum *b, BcNum *restrict c, size_t sub) {
+
+	BcStatus s;
+	ssize_t cmp;
+	BcNum *minuend, *subtrahend;
+	size_t start, diff;
+	bool aneg, bneg, neg;
+
+	// Because this function doesn't need to use scale (per the bc spec),
+	// I am hijacking it to say whether it's doing an add or a subtract.
+
+	if (a->len == 0) {
+		bc_num_copy(c, b);
+		if (sub && c->len) c->neg = !c->neg;
+		return BC_STATUS_SUCCESS;
+	}
+	else if (b->len == 0) {
+		bc_num_copy(c, a);
+		return BC_STATUS_SUCCESS;
+	}
+
+	aneg = a->neg;
+	bneg = b->neg;
+	a->neg = b->neg = false;
+
+	cmp = bc_num_cmp(a, b);
+
+	a->neg = aneg;
+	b->neg = bneg;
+
+	if (cmp == 0) {
+		bc_num_setToZero(c, BC_MAX(a->scale, b->scale));
+		return BC_STATUS_SUCCESS;
+	}
+	else if (cmp > 0) {
+		neg = a->neg;
+		minuend = a;
+		subtrahend = b;
+	}
+	else {
+		neg = b->neg;
+		if (sub) neg = !neg;
+		minuend = b;
+		subtrahend = a;
+	}
+
+	bc_num_copy(c, minuend);
+	c->neg = neg;
+
+	if (c->scale < subtrahend->scale)
+		bc_num_extend(c, subtrahend->scale - c->scale);
+
+	// The subtrahend may have limbs below the ones c stores.
+	start = c->rdx - subtrahend->rdx + subtrahend->off;
+
+	if (start < c->off) {
+		diff = c->off - start;
+		bc_num_expand(c, c->len + diff);
+		memmove(c->num + diff, c->num, c->len * sizeof(BcDig));
+		memset(c->num, 0, diff * sizeof(BcDig));
+		c->len += diff;
+		c->off = start;
+	}
+
+	s = bc_num_subArrays(c->num + start - c->off, subtrahend->num,
+	                     subtrahend->len);
+
+	bc_num_clean(c);
+
+	return s;
+}
+
+// This is the schoolbook method, done a column at a time (Comba's method): all
+// of the products that go into a limb of c are summed before carrying. That
+// is one division per BC_NUM_COMBA_LEN products instead of one per product,
+// and the sum of a column can be vectorized.
+//
+// Only the columns from lo up are computed, and column k goes in c[k - lo];
+// the carries out of the columns below lo are left out.
+void bc_num_mulArrays(BcDig *restrict c, BcDig *restrict a, size_t alen,
+                      BcDig *restrict b, size_t blen, size_t lo)
+{
+	size_t i, j, k, hi, n;
+	BcBigDig sum, carry;
+
+	for (carry = 0, k = lo; !bcg.signe && k < alen + blen - 1; ++k) {
+
+		i = k < blen ? 0 : k - blen + 1;
+		hi = BC_MIN(k + 1, alen);
+
+		for (sum = carry, carry = 0; i < hi; i += n) {
+
+			n = BC_MIN(hi - i, BC_NUM_COMBA_LEN);
+
+			for (j = i; j < i + n; ++j)
+				sum += (BcBigDig) (uint32_t) a[j] * (uint32_t) b[k - j];
+
+			carry += sum / BC_BASE_POW;
+			sum %= BC_BASE_POW;
+		}
+
+		c[k - lo] = (BcDig) sum;
+	}
+
+	c[k - lo] = (BcDig) carry;
+}
+
+// Squares like bc_num_mulArrays(), but every product a[i] * a[j] with i != j
+// shows up twice in its column, so each is computed once and the sum doubled.
+void bc_num_sqrArrays(BcDig *restrict c, BcDig *restrict a, size_t len) {
+
+	size_t i, j, k, hi, n;
+	BcBigDig sum, cross, carry, hicarry;
+
+	for (carry = 0, k = 0; !bcg.signe && k < 2 * len - 1; ++k) {
+
+		i = k < len ? 0 : k - len + 1;
+		hi = (k + 1) / 2;
+
+		for (cross = 0, hicarry = 0; i < hi; i += n) {
+
+			n = BC_MIN(hi - i, BC_NUM_COMBA_LEN);
+
+			for (j = i; j < i + n; ++j)
+				cross += (BcBigDig) (uint32_t) a[j] * (uint32_t) a[k - j];
+
+			hicarry += cross / BC_BASE_POW;
+			cross %= BC_BASE_POW;
+		}
+
+		sum = carry + 2 * cross;
+		if (!(k & 1)) {
+			j = (uint32_t) a[k / 2];
+			sum += (BcBigDig) j * j;
+		}
+
+		carry = 2 * hicarry + sum / BC_BASE_POW;
+		c[k] = (BcDig) (sum % BC_BASE_POW);
+	}
+
+	c[k] = (BcDig) carry;
+}
+
+void bc_num_piece(BcNum *restrict n, size_t idx, size_t len,
+                  BcNum *restrict p)
+{
+	bc_num_zero(p);
+
+	if (idx < n->len) {
+		len = BC_MIN(len, n->len - idx);
+		bc_num_expand(p, len);
+		memcpy(p->num, n->num + idx, len * sizeof(BcDig));
+		p->len = len;
+		bc_num_clean(p);
+	}
+}
+
+// Evaluates the polynomial with the k coefficients in p at x.
+BcStatus bc_num_toomEval(BcNum *p, size_t k, ssize_t x, BcNum *restrict v) {
+
+	BcStatus s = BC_STATUS_SUCCESS;
+	size_t i;
+
+	bc_num_copy(v, p + k - 1);
+
+	for (i = k - 2; !s && i < k; --i) {
+		bc_num_mulWord(v, (BcBigDig) (x < 0 ? -x : x));
+		if (x < 0 && v->len != 0) v->neg = !v->neg;
+		s = bc_num_add(v, p + i, v, 0);
+	}
+
+	return s;
+}
+
+BcStatus bc_num_subMul(BcNum *a, BcNum *b, BcBigDig w, BcNum *restrict t) {
+	bc_num_copy(t, b);
+	bc_num_mulWord(t, w);
+	return bc_num_sub(a, t, a, 0);
+}
+
+// Toom-Cook multiplication with k = 3 or 4. a and b are split into k pieces of
+// len limbs each, which are taken as the coefficients of two polynomials. The
+// polynomials are evaluated at 2k - 1 points (0, 1, -1, 2, -2, 3 and infinity
+// for k = 4; the first four and infinity for k = 3), multiplied there, and
+// the product is interpolated back. The even and odd coefficients of the
+// product are split apart with the pairs of points of opposite sign, so all
+// divisions in the interpolation are exact divisions by a small word.
+BcStatus bc_num_toom(BcNum *a, BcNum *b, BcNum *restrict c, size_t k) {
+
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum pa[4], pb[4], va, vb, r[7], t[4], u, *coef[7];
+	size_t i, pts = 2 * k - 1;
+	size_t len = (BC_MAX(a->len, b->len) + k - 1) / k;
+	ssize_t x[] = { 1, -1, 2, -2, 3 };
+
+	assert(k == 3 || k == 4);
+
+	for (i = 0; i < k; ++i) {
+		bc_num_init(pa + i, len);
+		bc_num_init(pb + i, len);
+		bc_num_piece(a, i * len, len, pa + i);
+		bc_num_piece(b, i * len, len, pb + i);
+	}
+
+	bc_num_init(&va, len + 1);
+	bc_num_init(&vb, len + 1);
+	bc_num_init(&u, 2 * len + 2);
+	for (i = 0; i < pts; ++i) bc_num_init(r + i, 2 * len + 2);
+	for (i = 0; i < 4; ++i) bc_num_init(t + i, 2 * len + 2);
+
+	s = bc_num_mul(pa, pb, r, 0);
+	if (s) goto err;
+	s = bc_num_mul(pa + k - 1, pb + k - 1, r + pts - 1, 0);
+	if (s) goto err;
+
+	for (i = 1; i < pts - 1; ++i) {
+		s = bc_num_toomEval(pa, k, x[i - 1], &va);
+		if (s) goto err;
+		if (a != b) {
+			s = bc_num_toomEval(pb, k, x[i - 1], &vb);
+			if (s) goto err;
+		}
+		s = bc_num_mul(&va, a != b ? &vb : &va, r + i, 0);
+		if (s) goto err;
+	}
+
+	// The even and odd coefficients at 1 and -1.
+	s = bc_num_add(r + 1, r + 2, t, 0);
+	if (s) goto err;
+	s = bc_num_sub(r + 1, r + 2, t + 1, 0);
+	if (s) goto err;
+	bc_num_divWord(t, 2);
+	bc_num_divWord(t + 1, 2);
+
+	s = bc_num_sub(t, r, t, 0);
+	if (s) goto err;
+	s = bc_num_sub(t, r + pts - 1, t, 0);
+	if (s) goto err;
+
+	coef[0] = r;
+	coef[pts - 1] = r + pts - 1;
+
+	if (k == 3) {
+
+		// t[0] = c2, t[1] = c1 + c3, and r[3] becomes c1 + 4c3.
+		s = bc_num_sub(r + 3, r, r + 3, 0);
+		if (s) goto err;
+		s = bc_num_subMul(r + 3, t, 4, &u);
+		if (s) goto err;
+		s = bc_num_subMul(r + 3, r + 4, 16, &u);
+		if (s) goto err;
+		bc_num_divWord(r + 3, 2);
+
+		s = bc_num_sub(r + 3, t + 1, r + 3, 0);
+		if (s) goto err;
+		bc_num_divWord(r + 3, 3);
+		s = bc_num_sub(t + 1, r + 3, t + 1, 0);
+		if (s) goto err;
+
+		coef[1] = t + 1;
+		coef[2] = t;
+		coef[3] = r + 3;
+	}
+	else {
+
+		// t[0] = c2 + c4 and t[1] = c1 + c3 + c5. Then t[2] becomes c2 + 4c4
+		// and t[3] c1 + 4c3 + 16c5 from the points 2 and -2.
+		s = bc_num_add(r + 3, r + 4, t + 2, 0);
+		if (s) goto err;
+		s = bc_num_sub(r + 3, r + 4, t + 3, 0);
+		if (s) goto err;
+		bc_num_divWord(t + 2, 2);
+		bc_num_divWord(t + 3, 4);
+
+		s = bc_num_sub(t + 2, r, t + 2, 0);
+		if (s) goto err;
+		s = bc_num_subMul(t + 2, r + 6, 64, &u);
+		if (s) goto err;
+		bc_num_divWord(t + 2, 4);
+
+		s = bc_num_sub(t + 2, t, t + 2, 0);
+		if (s) goto err;
+		bc_num_divWord(t + 2, 3);
+		s = bc_num_sub(t, t + 2, t, 0);
+		if (s) goto err;
+
+		// Now t[0] = c2 and t[2] = c4, and r[5] becomes c1 + 9c3 + 81c5.
+		s = bc_num_sub(r + 5, r, r + 5, 0);
+		if (s) goto err;
+		s = bc_num_subMul(r + 5, t, 9, &u);
+		if (s) goto err;
+		s = bc_num_subMul(r + 5, t + 2, 81, &u);
+		if (s) goto err;
+		s = bc_num_subMul(r + 5, r + 6, 729, &u);
+		if (s) goto err;
+		bc_num_divWord(r + 5, 3);
+
+		// Differences of those leave c3 + 13c5 in r[5] and c3 + 5c5 in t[3].
+		s = bc_num_sub(r + 5, t + 3, r + 5, 0);
+		if (s) goto err;
+		bc_num_divWord(r + 5, 5);
+		s = bc_num_sub(t + 3, t + 1, t + 3, 0);
+		if (s) goto err;
+		bc_num_divWord(t + 3, 3);
+
+		s = bc_num_sub(r + 5, t + 3, r + 5, 0);
+		if (s) goto err;
+		bc_num_divWord(r + 5, 8);
+		s = bc_num_subMul(t + 3, r + 5, 5, &u);
+		if (s) goto err;
+		s = bc_num_sub(t + 1, t + 3, t + 1, 0);
+		if (s) goto err;
+		s = bc_num_sub(t + 1, r + 5, t + 1, 0);
+		if (s) goto err;
+
+		coef[1] = t + 1;
+		coef[2] = t;
+		coef[3] = t + 3;
+		coef[4] = t + 2;
+		coef[5] = r + 5;
+	}
+
+	bc_num_zero(c);
+
+	for (i = 0; i < pts; ++i) {
+		s = bc_num_shift(coef[i], i * len * BC_BASE_DIGS);
+		if (s) goto err;
+		s = bc_num_add(c, coef[i], c, 0);
+		if (s) goto err;
+	}
+
+	// The pieces were split from the stored limbs only.
+	if (c->len != 0) c->off += a->off + b->off;
+
+err:
+	for (i = 0; i < 4; ++i) bc_num_free(t + i);
+	for (i = 0; i < pts; ++i) bc_num_free(r + i);
+	bc_num_free(&u);
+	bc_num_free(&vb);
+	bc_num_free(&va);
+	for (i = 0; i < k; ++i) {
+		bc_num_free(pb + i);
+		bc_num_free(pa + i);
+	}
+	return s;
+}
+
+uint32_t bc_num_nttPow(uint32_t b, size_t e, uint32_t p) {
+
+	BcBigDig res = 1, pow = b;
+
+	for (; e != 0; e >>= 1) {
+		if (e & 1) res = res * pow % p;
+		pow = pow * pow % p;
+	}
+
+	return (uint32_t) res;
+}
+
+// Montgomery multiplication with R = 2^32; pinv is -1/p mod R. Since p is less
+// than 2^31, nothing overflows a BcBigDig.
+uint32_t bc_num_nttMul(uint32_t a, uint32_t b, uint32_t p, uint32_t pinv) {
+
+	BcBigDig t = (BcBigDig) a * b;
+	uint32_t m = (uint32_t) t * pinv;
+
+	t = (t + (BcBigDig) m * p) >> 32;
+
+	return (uint32_t) (t >= p ? t - p : t);
+}
+
+// An in place, iterative radix-2 transform of n (a power of two) values in
+// Montgomery form. root is a primitive nth root of unity, not in Montgomery
+// form.
+void bc_num_ntt(uint32_t *a, size_t n, uint32_t root, uint32_t p,
+                uint32_t pinv, uint32_t one, uint32_t r2)
+{
+	size_t i, j, k, len, half;
+	uint32_t t, u, v, w, wlen;
+
+	for (i = 1, j = 0; i < n; ++i) {
+		for (k = n >> 1; j & k; k >>= 1) j ^= k;
+		j |= k;
+		if (i < j) {
+			t = a[i];
+			a[i] = a[j];
+			a[j] = t;
+		}
+	}
+
+	for (len = 2; !bcg.signe && len <= n; len <<= 1) {
+
+		half = len >> 1;
+		wlen = bc_num_nttMul(bc_num_nttPow(root, n / len, p), r2, p, pinv);
+
+		for (i = 0; i < n; i += len) {
+			for (w = one, j = 0; j < half; ++j) {
+				u = a[i + j];
+				v = bc_num_nttMul(a[i + j + half], w, p, pinv);
+				a[i + j] = u + v >= p ? u + v - p : u + v;
+				a[i + j + half] = u >= v ? u - v : u + p - v;
+				w = bc_num_nttMul(w, wlen, p, pinv);
+			}
+		}
+	}
+}
+
+// Multiplies with a number-theoretic transform. The limbs are convolved modulo
+// each of the primes in bc_num_ntt_primes, and every limb of the convolution is
+// put back together from its residues with Garner's algorithm, which gives it
+// as r1 + p1 * y, where y < p2 * p3.
+BcStatus bc_num_nttArrays(BcDig *restrict c, BcDig *restrict a, size_t alen,
+                          BcDig *restrict b, size_t blen)
+{
+	uint32_t *buf[BC_NUM_NTT_PRIMES + 1], *fa, *fb;
+	uint32_t p, pinv, one, r2, root, ninv, i12, i13, i23;
+	uint32_t p1 = bc_num_ntt_primes[0], p2 = bc_num_ntt_primes[1];
+	uint32_t p3 = bc_num_ntt_primes[2];
+	BcBigDig x1, t2, t3, y, in, high, carry;
+	size_t i, j, n, len = alen + blen - 1;
+	bool sqr = a == b && alen == blen;
+
+	for (n = 1; n < len; n <<= 1);
+
+	for (i = 0; i < BC_NUM_NTT_PRIMES; ++i)
+		buf[i] = bc_vm_malloc(n * sizeof(uint32_t));
+	buf[i] = sqr ? NULL : bc_vm_malloc(n * sizeof(uint32_t));
+
+	for (j = 0; !bcg.signe && j < BC_NUM_NTT_PRIMES; ++j) {
+
+		p = bc_num_ntt_primes[j];
+		fa = buf[j];
+
+		for (pinv = p, i = 0; i < 4; ++i) pinv *= 2 - p * pinv;
+		pinv = -pinv;
+		one = (uint32_t) ((((BcBigDig) 1) << 32) % p);
+		r2 = (uint32_t) ((BcBigDig) one * one % p);
+		root = bc_num_nttPow(bc_num_ntt_roots[j], (p - 1) / n, p);
+
+		for (i = 0; i < n; ++i) {
+			fa[i] = i < alen ? (uint32_t) a[i] % p : 0;
+			fa[i] = bc_num_nttMul(fa[i], r2, p, pinv);
+		}
+
+		bc_num_ntt(fa, n, root, p, pinv, one, r2);
+
+		// A square needs only one forward transform.
+		if (sqr) fb = fa;
+		else {
+
+			fb = buf[BC_NUM_NTT_PRIMES];
+
+			for (i = 0; i < n; ++i) {
+				fb[i] = i < blen ? (uint32_t) b[i] % p : 0;
+				fb[i] = bc_num_nttMul(fb[i], r2, p, pinv);
+			}
+
+			bc_num_ntt(fb, n, root, p, pinv, one, r2);
+		}
+
+		for (i = 0; i < n; ++i) fa[i] = bc_num_nttMul(fa[i], fb[i], p, pinv);
+
+		bc_num_ntt(fa, n, bc_num_nttPow(root, p - 2, p), p, pinv, one, r2);
+
+		// Multiplying by a number not in Montgomery form takes the values out
+		// of it, so this divides by n at the same time.
+		ninv = bc_num_nttPow((uint32_t) (n % p), p - 2, p);
+		for (i = 0; i < len; ++i) fa[i] = bc_num_nttMul(fa[i], ninv, p, pinv);
+	}
+
+	if (bcg.signe) goto err;
+
+	i12 = bc_num_nttPow(p1 % p2, p2 - 2, p2);
+	i13 = bc_num_nttPow(p1 % p3, p3 - 2, p3);
+	i23 = bc_num_nttPow(p2 % p3, p3 - 2, p3);
+
+	for (high = carry = 0, i = 0; i < len; ++i) {
+
+		x1 = buf[0][i];
+		t2 = (buf[1][i] + p2 - x1 % p2) * i12 % p2;
+		t3 = (buf[2][i] + p3 - x1 % p3) * i13 % p3;
+		t3 = (t3 + p3 - t2 % p3) * i23 % p3;
+		y = t2 + t3 * p2;
+
+		in = carry + high + x1 + p1 * (y % BC_BASE_POW);
+		high = p1 * (y / BC_BASE_POW);
+		c[i] = (BcDig) (in % BC_BASE_POW);
+		carry = in / BC_BASE_POW;
+	}
+
+	in = carry + high;
+	c[len] = (BcDig) (in % BC_BASE_POW);
+	assert(in / BC_BASE_POW == 0);
+
+err:
+	for (i = 0; i <= BC_NUM_NTT_PRIMES; ++i) free(buf[i]);
+	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+}
+
+// Karatsuba on arrays of limbs. c gets all alen + blen limbs of the product,
+// and scratch needs bc_num_kScratch(BC_MAX(alen, blen)) limbs. Since the sums
+// of the halves are not trimmed, every limb that is read has been written.
+void bc_num_kArrays(BcDig *restrict c, BcDig *a, size_t alen, BcDig *b,
+                    size_t blen, BcDig *scratch)
+{
+	BcDig *ptr;
+	size_t i, h;
+
+	if (alen < blen) {
+		ptr = a;
+		a = b;
+		b = ptr;
+		i = alen;
+		alen = blen;
+		blen = i;
+	}
+
+	if (bcg.signe) return;
+
+	if (blen < BC_NUM_KARATSUBA_LEN || alen < BC_NUM_KARATSUBA_MIN) {
+		if (a == b && alen == blen) bc_num_sqrArrays(c, a, alen);
+		else bc_num_mulArrays(c, a, alen, b, blen, 0);
+		return;
+	}
+
+	h = (alen + 1) / 2;
+	ptr = scratch + 4 * h + 4;
+
+	// If b is no longer than the low half of a, only a is split.
+	if (blen <= h) {
+
+		bc_num_kArrays(c, a, h, b, blen, ptr);
+		bc_num_kArrays(scratch, a + h, alen - h, b, blen, ptr);
+
+		memset(c + h + blen, 0, (alen - h) * sizeof(BcDig));
+		bc_num_addTo(c + h, alen + blen - h, scratch, alen - h + blen);
+
+		return;
+	}
+
+	bc_num_kArrays(c, a, h, b, h, ptr);
+	bc_num_kArrays(c + 2 * h, a + h, alen - h, b + h, blen - h, ptr);
+
+	memcpy(scratch, a, h * sizeof(BcDig));
+	scratch[h] = 0;
+	bc_num_addTo(scratch, h + 1, a + h, alen - h);
+
+	// A square needs only one sum, and squaring it keeps the recursion square.
+	if (a == b && alen == blen) b = scratch;
+	else {
+		memcpy(scratch + h + 1, b, h * sizeof(BcDig));
+		scratch[2 * h + 1] = 0;
+		bc_num_addTo(scratch + h + 1, h + 1, b + h, blen - h);
+		b = scratch + h + 1;
+	}
+
+	bc_num_kArrays(scratch + 2 * h + 2, scratch, h + 1, b, h + 1, ptr);
+	ptr = scratch + 2 * h + 2;
+
+	bc_num_subArrays(ptr, c, 2 * h);
+	bc_num_subArrays(ptr, c + 2 * h, alen + blen - 2 * h);
+
+	bc_num_addTo(c + h, alen + blen - h, ptr,
+	             BC_MIN(2 * h + 2, alen + blen - h));
+}
+
+// Multiplies a by a much shorter b a piece of a at a time, each piece as long as
+// b. Each product is balanced, so the time is linear in the length of a.
+BcStatus bc_num_kChunks(BcNum *restrict a, BcNum *restrict b,
+                        BcNum *restrict c)
+{
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum piece, prod;
+	size_t i, idx, len = a->len + b->len;
+
+	bc_num_expand(c, len);
+	memset(c->num, 0, len * sizeof(BcDig));
+
+	bc_num_init(&prod, 2 * b->len);
+	memset(&piece, 0, sizeof(BcNum));
+
+	for (i = 0; !s && i < a->len; i += b->len) {
+
+		// The pieces are clean views into a.
+		piece.num = a->num + i;
+		piece.len = BC_MIN(b->len, a->len - i);
+		for (piece.off = 0; piece.len && !piece.num[0]; ++piece.off, --piece.len)
+			++piece.num;
+		while (piece.len != 0 && !piece.num[piece.len - 1]) --piece.len;
+
+		if (piece.len == 0) continue;
+
+		s = bc_num_mul(&piece, b, &prod, 0);
+		if (s) break;
+
+		idx = i + prod.off - b->off;
+		bc_num_addTo(c->num + idx, len - idx, prod.num, prod.len);
+	}
+
+	bc_num_free(&prod);
+
+	c->len = len;
+	c->off = a->off + b->off;
+	bc_num_clean(c);
+
+	return s;
+}
+
+BcStatus bc_num_k(BcNum *restrict a, BcNum *restrict b, BcNum *restrict c) {
+
+	BcStatus s;
+	BcDig *scratch = NULL, *bnum;
+	size_t size;
+	bool ntt, sqr, aone = BC_NUM_ONE(a);
+
+	if (bcg.signe) return BC_STATUS_EXEC_SIGNAL;
 	if (a->len == 0 || b->len == 0) {
 		bc_num_zero(c);
 		return BC_STATUS_SUCCESS;
@@ -371,248 +1754,883 @@ BcStatus bc_num_k(BcNum *restrict a, BcNum *restrict b, BcNum *restrict c) {
 		return BC_STATUS_SUCCESS;
 	}
 
-	if (a->len + b->len < BC_NUM_KARATSUBA_LEN ||
-	    a->len < BC_NUM_KARATSUBA_LEN || b->len < BC_NUM_KARATSUBA_LEN)
-	{
-		bc_num_expand(c, a->len + b->len + 1);
+	ntt = a->len >= BC_NUM_NTT_LEN && b->len >= BC_NUM_NTT_LEN &&
+	      a->len + b->len <= BC_NUM_NTT_MAX;
+
+	if (!ntt && BC_MIN(a->len, b->len) >= BC_NUM_KARATSUBA_LEN) {
+		if (a->len >= 2 * b->len) return bc_num_kChunks(a, b, c);
+		if (b->len >= 2 * a->len) return bc_num_kChunks(b, a, c);
+	}
+
+	// Squares, even of copies, are passed down as a times itself, which all
+	// of the algorithms below recognize.
+	sqr = a->len == b->len && a->off == b->off && (a->num == b->num ||
+	      !memcmp(a->num, b->num, a->len * sizeof(BcDig)));
+	bnum = sqr ? a->num : b->num;
+
+	if (!ntt && a->len >= BC_NUM_TOOM4_LEN && b->len >= BC_NUM_TOOM4_LEN)
+		return bc_num_toom(a, sqr ? a : b, c, 4);
+	if (!ntt && a->len >= BC_NUM_TOOM3_LEN && b->len >= BC_NUM_TOOM3_LEN)
+		return bc_num_toom(a, sqr ? a : b, c, 3);
+
+	bc_num_expand(c, a->len + b->len);
+
+	if (ntt) {
+		s = bc_num_nttArrays(c->num, a->num, a->len, bnum, b->len);
+		if (s) return s;
+	}
+	else {
+
+		size = bc_num_kScratch(BC_MAX(a->len, b->len));
+		if (size != 0) scratch = bc_vm_malloc(size * sizeof(BcDig));
+
+		bc_num_kArrays(c->num, a->num, a->len, bnum, b->len, scratch);
+
+		free(scratch);
+	}
+
+	c->len = a->len + b->len;
+	c->off = a->off + b->off;
+	bc_num_clean(c);
+
+	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+}
+
+// Multiplies when the limbs of the product below drop are truncated away,
+// computing only the columns of the product from two guard limbs below drop
+// up. The columns left out add less than min(a->len, b->len) * BC_BASE_POW to
+// the guard limbs, so unless the top guard limb is close enough to overflow
+// for that to carry into a limb that is kept, the kept limbs are exact. This
+// returns false, and leaves c to the full product, if that is not the case or
+// the short product would not be worth it.
+bool bc_num_mShort(BcNum *a, BcNum *b, BcNum *restrict c, size_t drop) {
+
+	size_t lo, len = a->len + b->len, m = BC_MIN(a->len, b->len);
+
+	if (m == 0 || m >= BC_NUM_SHORT_LEN || drop < a->off + b->off + 3)
+		return false;
+
+	lo = drop - a->off - b->off - 2;
+
+	// Squares are cheaper in full, and there has to be a limb to keep.
+	if (lo + 2 >= len || (a->num == b->num && a->len == b->len)) return false;
+
+	bc_num_expand(c, len - lo);
+	bc_num_mulArrays(c->num, a->num, a->len, b->num, b->len, lo);
+
+	if ((BcBigDig) c->num[1] + m + 1 >= BC_BASE_POW) return false;
+
+	c->len = len - lo;
+	c->off = a->off + b->off + lo;
+	bc_num_clean(c);
+
+	return true;
+}
+
+BcStatus bc_num_m(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum cpa, cpb;
+
+	scale = BC_MAX(scale, a->scale);
+	scale = BC_MAX(scale, b->scale);
+	scale = BC_MIN(a->scale + b->scale, scale);
+
+	// A single limb, like 2, 0.5 or any power of ten, only needs one pass of
+	// word multiplies, and the powers of BC_BASE_POW none at all.
+	if (a->len == 1 || b->len == 1) {
+
+		BcNum *n = b->len == 1 ? a : b, *w = b->len == 1 ? b : a;
+
+		bc_num_copy(c, n);
+		bc_num_mulWord(c, (BcBigDig) w->num[0]);
+
+		if (c->len != 0) c->off += w->off;
+		c->rdx = a->rdx + b->rdx;
+		c->scale = c->rdx * BC_BASE_DIGS;
+
+		bc_num_retireMul(c, scale, a->neg, b->neg);
+
+		return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+	}
+
+	// Since the limbs are aligned on the radix, the arrays can be multiplied
+	// as integers as they are; the product then has a->rdx + b->rdx limbs of
+	// fraction.
+	memcpy(&cpa, a, sizeof(BcNum));
+	memcpy(&cpb, b, sizeof(BcNum));
+	cpa.rdx = cpb.rdx = cpa.scale = cpb.scale = 0;
+	cpa.neg = cpb.neg = false;
+
+	if (bc_num_mShort(&cpa, &cpb, c, a->rdx + b->rdx - BC_NUM_RDX(scale))) {
+		if (bcg.signe) return BC_STATUS_EXEC_SIGNAL;
+	}
+	else {
+		s = bc_num_k(&cpa, &cpb, c);
+		if (s) return s;
+	}
+
+	c->rdx = a->rdx + b->rdx;
+	c->scale = c->rdx * BC_BASE_DIGS;
+
+	bc_num_retireMul(c, scale, a->neg, b->neg);
+
+	return s;
+}
+
+// Divides the integer n by BC_BASE_POW^places, rounding toward zero.
+void bc_num_divLimbs(BcNum *n, size_t places) {
+
+	if (n->len == 0) return;
+
+	if (places <= n->off) {
+		n->off -= places;
+		return;
+	}
+
+	places -= n->off;
+	n->off = 0;
+
+	if (places >= n->len) {
+		bc_num_zero(n);
+		return;
+	}
+
+	n->len -= places;
+	memmove(n->num, n->num + places, n->len * sizeof(BcDig));
+	bc_num_clean(n);
+}
+
+// Long division of the nlen limbs of n, the top one of which has to be 0, by
+// the len limbs of p, the top one of which can't be. The nlen - len limbs of
+// the quotient go in q, unless it is NULL, and the bottom len limbs of n are
+// left with the remainder.
+//
+// This is Knuth's Algorithm D: n and p are first multiplied by a factor that
+// makes the top limb of p at least BC_BASE_POW / 2. Then each limb of the
+// quotient, estimated from the top two limbs of the window, is at most one
+// too big after checking it against the next limb of p, so it takes at most
+// one add back to fix.
+void bc_num_divArrays(BcDig *restrict n, size_t nlen, BcDig *restrict p,
+                      size_t len, BcDig *restrict q)
+{
+	BcDig *d = p, *w;
+	BcBigDig f, in, qhat, rhat, carry, top, next;
+	size_t i, end = nlen - len;
+
+	if (len == 1) {
+
+		for (rhat = 0, i = end - 1; i < end; --i) {
+			rhat = rhat * BC_BASE_POW + (BcBigDig) n[i];
+			if (q) q[i] = (BcDig) (rhat / (BcBigDig) p[0]);
+			rhat %= (BcBigDig) p[0];
+			n[i] = 0;
+		}
+
+		n[0] = (BcDig) rhat;
+
+		return;
+	}
+
+	f = BC_BASE_POW / ((BcBigDig) p[len - 1] + 1);
+
+	if (f > 1) {
+
+		d = bc_vm_malloc(len * sizeof(BcDig));
+
+		for (carry = 0, i = 0; i < len; ++i) {
+			in = ((BcBigDig) p[i]) * f + carry;
+			d[i] = (BcDig) (in % BC_BASE_POW);
+			carry = in / BC_BASE_POW;
+		}
+
+		for (carry = 0, i = 0; i < nlen; ++i) {
+			in = ((BcBigDig) n[i]) * f + carry;
+			n[i] = (BcDig) (in % BC_BASE_POW);
+			carry = in / BC_BASE_POW;
+		}
+	}
+
+	top = (BcBigDig) d[len - 1];
+	next = (BcBigDig) d[len - 2];
+
+	for (i = end - 1; !bcg.signe && i < end; --i) {
+
+		w = n + i;
+
+		in = ((BcBigDig) w[len]) * BC_BASE_POW + (BcBigDig) w[len - 1];
+		qhat = in / top;
+		rhat = in % top;
+
+		while (qhat >= BC_BASE_POW ||
+		       qhat * next > rhat * BC_BASE_POW + (BcBigDig) w[len - 2])
+		{
+			qhat -= 1;
+			rhat += top;
+			if (rhat >= BC_BASE_POW) break;
+		}
+
+		if (qhat != 0 && bc_num_mulSubArrays(w, d, len, qhat) < 0) {
+			qhat -= 1;
+			w[len] += bc_num_addArrays(w, w, d, len);
+		}
+
+		if (q) q[i] = (BcDig) qhat;
+	}
+
+	if (d != p) {
+
+		// The remainder was multiplied by f too.
+		for (rhat = 0, i = len - 1; i < len; --i) {
+			rhat = rhat * BC_BASE_POW + (BcBigDig) n[i];
+			n[i] = (BcDig) (rhat / f);
+			rhat %= f;
+		}
+
+		free(d);
+	}
+}
+
+// Sets x to about BC_BASE_POW^(2 * h) / y, where y is an integer with h limbs.
+// Short ones are divided into that; longer ones get a reciprocal of their top
+// h / 2 + 2 limbs, which is one Newton step, x + x * (1 - y * x), away from
+// one with twice the precision.
+BcStatus bc_num_recip(BcNum *y, size_t h, BcNum *restrict x) {
+
+	BcStatus s;
+	BcNum top, t, u, pow;
+	BcDig *n;
+	size_t l = h / 2 + 2;
+
+	assert(BC_NUM_TOP(y) == h && !y->rdx);
 
-		memset(c->num, 0, sizeof(BcDig) * c->cap);
-		c->len = carry = len = 0;
+	if (h < BC_NUM_NEWTON_LEN) {
 
-		for (i = 0; !bcg.signe && i < b->len; ++i) {
+		n = bc_vm_malloc((3 * h + 2) * sizeof(BcDig));
+		memset(n, 0, (2 * h + 2) * sizeof(BcDig));
+		n[2 * h] = 1;
 
-			for (j = 0; !bcg.signe && j < a->len; ++j) {
-				int in = (int) c->num[i + j];
-				in += ((int) a->num[j]) * ((int) b->num[i]) + carry;
-				carry = in / 10;
-				c->num[i + j] = (BcDig) (in % 10);
-			}
+		memset(n + 2 * h + 2, 0, y->off * sizeof(BcDig));
+		memcpy(n + 2 * h + 2 + y->off, y->num, y->len * sizeof(BcDig));
 
-			c->num[i + j] += (BcDig) carry;
-			len = BC_MAX(len, i + j + !!carry);
-			carry = 0;
-		}
+		bc_num_expand(x, h + 2);
+		bc_num_zero(x);
+		bc_num_divArrays(n, 2 * h + 2, n + 2 * h + 2, h, x->num);
+		x->len = h + 2;
+		bc_num_clean(x);
 
-		c->len = len;
+		free(n);
 
 		return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
 	}
 
-	bc_num_init(&l1, max);
-	bc_num_init(&h1, max);
-	bc_num_init(&l2, max);
-	bc_num_init(&h2, max);
-	bc_num_init(&m1, max);
-	bc_num_init(&m2, max);
-	bc_num_init(&z0, max);
-	bc_num_init(&z1, max);
-	bc_num_init(&z2, max);
-	bc_num_init(&temp, max + max);
-
-	bc_num_split(a, max2, &l1, &h1);
-	bc_num_split(b, max2, &l2, &h2);
+	bc_num_init(&top, l);
+	bc_num_init(&t, 2 * h + 2);
+	bc_num_init(&u, 2 * h + 2);
+	bc_num_init(&pow, BC_NUM_DEF_SIZE);
 
-	s = bc_num_add(&h1, &l1, &m1, 0);
-	if (s) goto err;
-	s = bc_num_add(&h2, &l2, &m2, 0);
-	if (s) goto err;
+	bc_num_copy(&top, y);
+	bc_num_divLimbs(&top, h - l);
 
-	s = bc_num_k(&h1, &h2, &z0);
-	if (s) goto err;
-	s = bc_num_k(&m1, &m2, &z1);
-	if (s) goto err;
-	s = bc_num_k(&l1, &l2, &z2);
+	s = bc_num_recip(&top, l, x);
 	if (s) goto err;
+	x->off += h - l;
 
-	s = bc_num_sub(&z1, &z0, &temp, 0);
-	if (s) goto err;
-	s = bc_num_sub(&temp, &z2, &z1, 0);
-	if (s) goto err;
+	bc_num_one(&pow);
+	pow.off = 2 * h;
 
-	s = bc_num_shift(&z0, max2 * 2);
+	s = bc_num_mul(y, x, &t, 0);
 	if (s) goto err;
-	s = bc_num_shift(&z1, max2);
+	s = bc_num_sub(&pow, &t, &t, 0);
 	if (s) goto err;
-	s = bc_num_add(&z0, &z1, &temp, 0);
+	s = bc_num_mul(x, &t, &u, 0);
 	if (s) goto err;
-	s = bc_num_add(&temp, &z2, c, 0);
+	bc_num_divLimbs(&u, 2 * h);
+	s = bc_num_add(x, &u, x, 0);
 
 err:
-	bc_num_free(&temp);
-	bc_num_free(&z2);
-	bc_num_free(&z1);
-	bc_num_free(&z0);
-	bc_num_free(&m2);
-	bc_num_free(&m1);
-	bc_num_free(&h2);
-	bc_num_free(&l2);
-	bc_num_free(&h1);
-	bc_num_free(&l1);
+	bc_num_free(&pow);
+	bc_num_free(&u);
+	bc_num_free(&t);
+	bc_num_free(&top);
 	return s;
 }
 
-BcStatus bc_num_m(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+// Puts the reciprocal of y to h limbs in x if it is in the cache.
+bool bc_num_cacheGet(BcNumCache *cache, BcNum *y, size_t h, BcNum *restrict x)
+{
+	BcNumRecip *r;
+	size_t i;
+
+	for (i = 0; i < cache->len; ++i) {
+
+		r = cache->recips + i;
+
+		if (r->h == h && r->y.off == y->off && r->y.len == y->len &&
+		    !memcmp(r->y.num, y->num, y->len * sizeof(BcDig)))
+		{
+			r->used = ++cache->clock;
+			cache->hits += 1;
+			bc_num_copy(x, &r->x);
+			return true;
+		}
+	}
+
+	cache->misses += 1;
+
+	return false;
+}
+
+void bc_num_cachePut(BcNumCache *cache, BcNum *y, size_t h, BcNum *x) {
+
+	BcNumRecip *r;
+	size_t i, j, limbs = y->cap + x->cap;
+
+	if (limbs > BC_NUM_RECIP_LIMBS) return;
+
+	while (cache->len == BC_NUM_RECIP_CACHE ||
+	       cache->limbs + limbs > BC_NUM_RECIP_LIMBS)
+	{
+		for (j = 0, i = 1; i < cache->len; ++i) {
+			if (cache->recips[i].used < cache->recips[j].used) j = i;
+		}
+
+		r = cache->recips + j;
+		cache->limbs -= r->y.cap + r->x.cap;
+		bc_num_free(&r->y);
+		bc_num_free(&r->x);
+		*r = cache->recips[--cache->len];
+	}
+
+	r = cache->recips + cache->len++;
+
+	bc_num_init(&r->y, y->cap);
+	bc_num_init(&r->x, x->cap);
+	bc_num_copy(&r->y, y);
+	bc_num_copy(&r->x, x);
+	r->h = h;
+	r->used = ++cache->clock;
+
+	cache->limbs += limbs;
+}
+
+void bc_num_cacheFree(BcNumCache *cache) {
+
+	size_t i;
+
+	for (i = 0; i < cache->len; ++i) {
+		bc_num_free(&cache->recips[i].y);
+		bc_num_free(&cache->recips[i].x);
+	}
+
+	memset(cache, 0, sizeof(BcNumCache));
+}
 
+// Divides the integer n by the integer d with a reciprocal of d that is good
+// to a few more limbs than the quotient has. The quotient, in q, is off by at
+// most a few from that, which the remainder, in r, fixes.
+BcStatus bc_num_newton(BcNum *n, BcNum *d, BcNum *restrict q,
+                       BcNum *restrict r)
+{
 	BcStatus s;
-	BcNum cpa, cpb;
-	size_t maxrdx = BC_MAX(a->rdx, b->rdx);
+	BcNum top, x, one;
+	size_t m = BC_NUM_TOP(d), h = BC_NUM_TOP(n) - m + 3;
 
-	scale = BC_MAX(scale, a->rdx);
-	scale = BC_MAX(scale, b->rdx);
-	scale = BC_MIN(a->rdx + b->rdx, scale);
-	maxrdx = BC_MAX(maxrdx, scale);
+	assert(m >= 2 && BC_NUM_TOP(n) >= m && !n->rdx && !d->rdx);
 
-	bc_num_init(&cpa, a->len);
-	bc_num_init(&cpb, b->len);
+	bc_num_init(&top, h + 1);
+	bc_num_init(&x, h + 2);
+	bc_num_init(&one, BC_NUM_DEF_SIZE);
+	bc_num_one(&one);
 
-	bc_num_copy(&cpa, a);
-	bc_num_copy(&cpb, b);
-	cpa.neg = cpb.neg = false;
+	// The top h limbs of d, or d with zeros appended if it is shorter.
+	bc_num_copy(&top, d);
+	if (m >= h) bc_num_divLimbs(&top, m - h);
+	else top.off += h - m;
+
+	if (!bc_num_cacheGet(&bcg.cache, &top, h, &x)) {
+		s = bc_num_recip(&top, h, &x);
+		if (s) goto err;
+		bc_num_cachePut(&bcg.cache, &top, h, &x);
+	}
+
+	// n / d is about n * x / BC_BASE_POW^(h + m), but the bottom m - 2 limbs
+	// of n are too small to matter.
+	bc_num_copy(&top, n);
+	bc_num_divLimbs(&top, m - 2);
 
-	s = bc_num_shift(&cpa, maxrdx);
+	s = bc_num_mul(&top, &x, q, 0);
 	if (s) goto err;
-	s = bc_num_shift(&cpb, maxrdx);
+	bc_num_divLimbs(q, h + 2);
+
+	s = bc_num_mul(q, d, r, 0);
 	if (s) goto err;
-	s = bc_num_k(&cpa, &cpb, c);
+	s = bc_num_sub(n, r, r, 0);
 	if (s) goto err;
 
-	maxrdx += scale;
-	bc_num_expand(c, c->len + maxrdx);
-
-	if (c->len < maxrdx) {
-		memset(c->num + c->len, 0, (c->cap - c->len) * sizeof(BcDig));
-		c->len += maxrdx;
+	while (!s && r->neg) {
+		s = bc_num_sub(q, &one, q, 0);
+		if (!s) s = bc_num_add(r, d, r, 0);
 	}
 
-	c->rdx = maxrdx;
-	bc_num_retireMul(c, scale, a->neg, b->neg);
+	while (!s && bc_num_cmp(r, d) >= 0) {
+		s = bc_num_add(q, &one, q, 0);
+		if (!s) s = bc_num_sub(r, d, r, 0);
+	}
 
 err:
-	bc_num_free(&cpb);
-	bc_num_free(&cpa);
+	bc_num_free(&one);
+	bc_num_free(&x);
+	bc_num_free(&top);
 	return s;
 }
 
-BcStatus bc_num_d(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+// Returns true if dig is 10^idx, and puts idx in idx.
+bool bc_num_pow10Idx(BcDig dig, size_t *idx) {
+
+	size_t i;
+
+	for (i = 0; i < BC_BASE_DIGS; ++i) {
+		if ((BcDig) bc_num_pow10[i] == dig) {
+			*idx = i;
+			return true;
+		}
+	}
+
+	return false;
+}
 
+// Divides a by b, and puts the quotient in c and the remainder in d, either of
+// which can be NULL. The remainder is what is left of a after the division,
+// so it is only a - c * b if c is exact to the limb (scale is a multiple of
+// BC_BASE_DIGS) and none of the limbs of a were cut off (see bc_num_r()).
+// It is left with its limbs, and it has to be retired by the caller.
+BcStatus bc_num_dr(BcNum *a, BcNum *b, BcNum *restrict c, BcNum *restrict d,
+                   size_t scale)
+{
 	BcStatus s = BC_STATUS_SUCCESS;
-	BcDig *n, *p, q;
-	size_t len, end, i;
-	BcNum cp;
-	bool zero = true;
+	BcDig *p;
+	size_t len, end, rdx, up, down;
+	BcNum cp, dv, q, r;
 
 	if (b->len == 0) return BC_STATUS_MATH_DIVIDE_BY_ZERO;
 	else if (a->len == 0) {
-		bc_num_setToZero(c, scale);
+		if (c) bc_num_setToZero(c, scale);
+		if (d) bc_num_setToZero(d, 0);
 		return BC_STATUS_SUCCESS;
 	}
 	else if (BC_NUM_ONE(b)) {
-		bc_num_copy(c, a);
-		bc_num_retireMul(c, scale, a->neg, b->neg);
+		if (c) {
+			bc_num_copy(c, a);
+			bc_num_retireMul(c, scale, a->neg, b->neg);
+		}
+		if (d) bc_num_setToZero(d, 0);
 		return BC_STATUS_SUCCESS;
 	}
 
-	bc_num_init(&cp, BC_NUM_MREQ(a, b, scale));
-	bc_num_copy(&cp, a);
-	len = b->len;
+	// Dividing by a power of ten only moves the radix, after a word multiply
+	// by the complement if it does not fall on a limb.
+	if (c && !d && b->len == 1 && bc_num_pow10Idx(b->num[0], &up)) {
 
-	if (len > cp.len) {
-		bc_num_expand(&cp, len + 2);
-		bc_num_extend(&cp, len - cp.len);
-	}
+		bc_num_copy(c, a);
+
+		down = a->rdx + b->off;
+		if (up != 0) {
+			bc_num_mulWord(c, bc_num_pow10[BC_BASE_DIGS - up]);
+			down += 1;
+		}
+
+		up = c->off + b->rdx;
+		c->off = up > down ? up - down : 0;
+		c->rdx = down > up ? down - up : 0;
+		c->scale = c->rdx * BC_BASE_DIGS;
+
+		bc_num_retireMul(c, scale, a->neg, b->neg);
 
-	if (b->rdx > cp.rdx) bc_num_extend(&cp, b->rdx - cp.rdx);
-	cp.rdx -= b->rdx;
-	if (scale > cp.rdx) bc_num_extend(&cp, scale - cp.rdx);
+		return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+	}
 
-	if (b->rdx == b->len) {
-		for (i = 0; zero && i < len; ++i) zero = !b->num[len - i - 1];
-		assert(i != len || !zero);
-		len -= i - 1;
+	p = b->num;
+	for (len = b->len; p[len - 1] == 0; --len);
+
+	// The quotient gets rdx limbs of fraction, so the stored limbs of the
+	// dividend, as an integer, need to be scaled by BC_BASE_POW^(up - down).
+	rdx = BC_NUM_RDX(scale);
+	up = rdx + b->rdx + a->off;
+	down = a->rdx + b->off;
+
+	if (up >= down) {
+		up -= down;
+		bc_num_init(&cp, a->len + up + len + 1);
+		memset(cp.num, 0, up * sizeof(BcDig));
+		memcpy(cp.num + up, a->num, a->len * sizeof(BcDig));
+		cp.len = a->len + up;
+	}
+	else {
+		down -= up;
+		bc_num_init(&cp, a->len + len + 1);
+		cp.len = a->len > down ? a->len - down : 0;
+		memcpy(cp.num, a->num + down, cp.len * sizeof(BcDig));
 	}
 
-	if (cp.cap == cp.len) bc_num_expand(&cp, cp.len + 1);
+	if (cp.len < len) {
+		memset(cp.num + cp.len, 0, (len - cp.len) * sizeof(BcDig));
+		cp.len = len;
+	}
 
 	// We want an extra zero in front to make things simpler.
 	cp.num[cp.len++] = 0;
 	end = cp.len - len;
 
-	bc_num_expand(c, cp.len);
+	if (c) {
+		bc_num_expand(c, end);
+		bc_num_zero(c);
+		memset(c->num, 0, c->cap * sizeof(BcDig));
+		c->rdx = rdx;
+		c->scale = rdx * BC_BASE_DIGS;
+		c->len = end;
+	}
+
+	// Long divisions by long divisors are done with a reciprocal instead.
+	if (BC_MIN(len, end) >= BC_NUM_NEWTON_LEN) {
 
-	bc_num_zero(c);
-	memset(c->num + end, 0, (c->cap - end) * sizeof(BcDig));
-	c->rdx = cp.rdx;
-	c->len = cp.len;
-	p = b->num;
+		memset(&dv, 0, sizeof(BcNum));
+		dv.num = p;
+		dv.len = dv.cap = len;
+
+		bc_num_clean(&cp);
+		bc_num_init(&q, end);
+		bc_num_init(&r, len);
+
+		s = bc_num_newton(&cp, &dv, &q, &r);
+
+		if (!s && c) memcpy(c->num + q.off, q.num, q.len * sizeof(BcDig));
+		if (!s && d) bc_num_copy(d, &r);
+
+		bc_num_free(&r);
+		bc_num_free(&q);
+	}
+	else {
+
+		bc_num_divArrays(cp.num, cp.len, p, len, c ? c->num : NULL);
+
+		if (d) {
+			bc_num_expand(d, len);
+			bc_num_zero(d);
+			memcpy(d->num, cp.num, len * sizeof(BcDig));
+			d->len = len;
+			bc_num_clean(d);
+		}
+	}
+
+	if (!s && bcg.signe) s = BC_STATUS_EXEC_SIGNAL;
+
+	if (!s && c) bc_num_retireMul(c, scale, a->neg, b->neg);
 
-	for (i = end - 1; !bcg.signe && !s && i < end; --i) {
-		n = cp.num + i;
-		for (q = 0; (!s && n[len] != 0) || bc_num_compare(n, p, len) >= 0; ++q)
-			s = bc_num_subArrays(n, p, len);
-		c->num[i] = q;
+	// The remainder was divided as an integer by the stored limbs of b.
+	if (!s && d && d->len != 0) {
+		d->off += b->off;
+		d->rdx = rdx + b->rdx;
+		d->scale = d->rdx * BC_BASE_DIGS;
+		d->neg = a->neg;
 	}
 
-	if (!s) bc_num_retireMul(c, scale, a->neg, b->neg);
 	bc_num_free(&cp);
 
 	return s;
 }
 
+BcStatus bc_num_d(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+	return bc_num_dr(a, b, c, NULL, scale);
+}
+
+// c can be NULL if only the remainder is needed.
 BcStatus bc_num_r(BcNum *a, BcNum *b, BcNum *restrict c,
                   BcNum *restrict d, size_t scale, size_t ts)
 {
 	BcStatus s;
-	BcNum temp;
+	BcNum temp, quo, *q;
 	bool neg;
 
 	if (b->len == 0) return BC_STATUS_MATH_DIVIDE_BY_ZERO;
 
 	if (a->len == 0) {
+		if (c) bc_num_setToZero(c, scale);
 		bc_num_setToZero(d, ts);
 		return BC_STATUS_SUCCESS;
 	}
 
-	bc_num_init(&temp, d->cap);
-	bc_num_d(a, b, c, scale);
+	// If the quotient is exact to the limb, and the division uses all of the
+	// limbs of a, the remainder is what the division leaves.
+	if (scale % BC_BASE_DIGS == 0 &&
+	    BC_NUM_RDX(scale) + b->rdx + a->off >= a->rdx + b->off)
+	{
+		s = bc_num_dr(a, b, c, d, scale);
+		if (s) return s;
+	}
+	else {
 
-	if (scale != 0) scale = ts;
+		bc_num_init(&temp, d->cap);
+		bc_num_init(&quo, BC_NUM_DEF_SIZE);
+		q = c ? c : &quo;
 
-	s = bc_num_m(c, b, &temp, scale);
-	if (s) goto err;
-	s = bc_num_sub(a, &temp, d, scale);
-	if (s) goto err;
+		s = bc_num_d(a, b, q, scale);
 
-	if (ts > d->rdx && d->len) bc_num_extend(d, ts - d->rdx);
+		if (scale != 0) scale = ts;
+
+		if (!s) s = bc_num_m(q, b, &temp, scale);
+		if (!s) s = bc_num_sub(a, &temp, d, scale);
+
+		bc_num_free(&quo);
+		bc_num_free(&temp);
+
+		if (s) return s;
+	}
+
+	if (ts > d->scale && d->len) bc_num_extend(d, ts - d->scale);
 
 	neg = d->neg;
 	bc_num_retireMul(d, ts, a->neg, b->neg);
 	d->neg = neg;
 
-err:
-	bc_num_free(&temp);
 	return s;
 }
 
 BcStatus bc_num_rem(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
 
-	BcStatus s;
-	BcNum c1;
-	size_t ts = BC_MAX(scale + b->rdx, a->rdx), len = BC_NUM_MREQ(a, b, ts);
+	size_t ts = BC_MAX(scale + b->scale, a->scale);
+	return bc_num_r(a, b, NULL, c, scale, ts);
+}
+
+// Returns how many bits of an exponent of bits bits to take at a time.
+size_t bc_num_window(size_t bits) {
+	size_t w;
+	w = bits > 671 ? 6 : bits > 239 ? 5 : bits > 79 ? 4 : bits > 23 ? 3 : 2;
+	return BC_MIN(w, BC_NUM_WINDOW);
+}
+
+// Truncates n to digits significant digits, or as close as its scale allows.
+void bc_num_truncDigits(BcNum *n, size_t digits) {
+
+	size_t keep, top;
+
+	if (n->len == 0) return;
+
+	top = bc_num_intDigits(n);
+
+	if (top) keep = digits > top ? digits - top : 0;
+	else keep = digits + bc_num_zeros(n);
+
+	if (n->scale > keep) bc_num_truncate(n, n->scale - keep);
+}
+
+// Sets c to a * b, exactly if digits is 0, and otherwise truncated to digits
+// significant digits.
+BcStatus bc_num_powMul(BcNum *a, BcNum *b, BcNum *c, size_t digits) {
+	BcStatus s = bc_num_mul(a, b, c, a->scale + b->scale);
+	if (!s && digits) bc_num_truncDigits(c, digits);
+	return s;
+}
+
+// Sets c to a^pow, for pow of at least 1, reading pow from the top in sliding
+// windows like bc_num_modexp() does (a single limb is multiplied by cheaply
+// enough to go one bit at a time). If digits is not 0, every product is cut to
+// that many digits; each cut can make it smaller by a factor of no more than
+// 1 - 10^(1 - digits), and err gets how many such factors the result has had.
+BcStatus bc_num_powWindow(BcNum *a, unsigned long pow, BcNum *restrict c,
+                          size_t digits, size_t *err)
+{
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum sq, pows[1 << (BC_NUM_WINDOW - 1)];
+	size_t i, j, w, bits, idx, npows, e, esq, errs[1 << (BC_NUM_WINDOW - 1)];
+	bool one = true;
+
+	assert(pow);
 
-	bc_num_init(&c1, len);
-	s = bc_num_r(a, b, &c1, c, scale, ts);
-	bc_num_free(&c1);
+	for (bits = sizeof(unsigned long) * CHAR_BIT; !(pow >> (bits - 1) & 1);)
+		--bits;
+
+	w = a->len == 1 ? 1 : bc_num_window(bits);
+	npows = ((size_t) 1) << (w - 1);
+
+	bc_num_init(&sq, BC_NUM_DEF_SIZE);
+	for (i = 0; i < npows; ++i) bc_num_init(&pows[i], a->len);
+
+	bc_num_copy(&pows[0], a);
+	if (digits) bc_num_truncDigits(&pows[0], digits);
+	errs[0] = digits != 0;
+
+	// pows[i] is a^(2 * i + 1).
+	if (w > 1) {
+
+		s = bc_num_powMul(&pows[0], &pows[0], &sq, digits);
+		esq = 2 * errs[0] + 1;
+
+		for (i = 1; !s && i < npows; ++i) {
+			s = bc_num_powMul(&pows[i - 1], &sq, &pows[i], digits);
+			errs[i] = errs[i - 1] + esq + 1;
+		}
+	}
+
+	for (e = 0, i = bits; !s && !bcg.signe && i > 0; i = j) {
+
+		j = i - 1;
+
+		if (pow >> j & 1) {
+
+			for (j = i > w ? i - w : 0; !(pow >> j & 1); ++j);
+
+			for (idx = 0; !s && i > j; --i) {
+				idx = idx << 1 | (pow >> (i - 1) & 1);
+				if (!one) {
+					s = bc_num_powMul(c, c, c, digits);
+					e = 2 * e + 1;
+				}
+			}
+
+			if (s) break;
+
+			idx >>= 1;
+
+			if (one) {
+				bc_num_copy(c, &pows[idx]);
+				e = errs[idx];
+			}
+			else {
+				s = bc_num_powMul(c, &pows[idx], c, digits);
+				e += errs[idx] + 1;
+			}
+
+			one = false;
+		}
+		else if (!one) {
+			s = bc_num_powMul(c, c, c, digits);
+			e = 2 * e + 1;
+		}
+	}
+
+	if (!s && bcg.signe) s = BC_STATUS_EXEC_SIGNAL;
+	if (err) *err = e;
+
+	for (i = 0; i < npows; ++i) bc_num_free(&pows[i]);
+	bc_num_free(&sq);
 
 	return s;
 }
 
+// Sets c to a^pow, or to 1 / a^pow if neg, to scale digits, without computing
+// a^pow to all of its digits. Returns false if that would not save much, or the
+// result could not be pinned down.
+//
+// a^pow is computed with truncated products (lo), and from how many truncations
+// there were, there is a bound above it (hi). If lo and hi give the same
+// result, so does the exact power. lo first has enough digits for the scale as
+// if a^pow were near 1, then for its real size once that is known, and they are
+// doubled if lo and hi still disagree, which is rare.
+bool bc_num_powTrunc(BcNum *a, unsigned long pow, bool neg, BcNum *restrict c,
+                     size_t scale, BcStatus *s)
+{
+	BcNum x, lo, hi, t;
+	size_t top, zeros, digits, guard, need, err, rdx, full;
+	unsigned long v;
+	bool done = false;
+
+	top = bc_num_intDigits(a);
+	zeros = top ? 0 : bc_num_zeros(a);
+	full = bc_num_len(a);
+
+	if (pow > SIZE_MAX / 4 / (top + zeros + full + 1)) return false;
+
+	// a^pow is below 10^(pow * top), or 10^-(pow * zeros), so these are zero.
+	if (neg ? top && pow * (top - 1) > scale : pow * zeros >= scale) {
+		bc_num_setToZero(c, scale);
+		*s = BC_STATUS_SUCCESS;
+		return true;
+	}
+
+	for (guard = 4, v = pow; v; v /= 10) guard += 1;
+	digits = scale + guard;
+
+	memcpy(&x, a, sizeof(BcNum));
+	x.neg = false;
+
+	bc_num_init(&lo, digits);
+	bc_num_init(&hi, digits);
+	bc_num_init(&t, digits);
+
+	for (*s = BC_STATUS_SUCCESS; !*s && !done && 2 * digits < pow * full;) {
+
+		*s = bc_num_powWindow(&x, pow, &lo, digits, &err);
+		if (*s) break;
+
+		// lo is below 10^top (or 10^-zeros), and so is a^pow, near enough.
+		top = bc_num_intDigits(&lo);
+		zeros = top ? 0 : bc_num_zeros(&lo);
+
+		if (!neg) need = scale + top > zeros ? scale + top - zeros : 1;
+		else need = scale + zeros + 1 > top ? scale + zeros + 1 - top : 1;
+		need += guard;
+
+		if (need > digits) {
+			digits = need;
+			continue;
+		}
+
+		// lo is at least a^pow * (1 - err * 10^(1 - digits)), so a^pow is less
+		// than 20 * err + 1 units of 10^(top - zeros + 1 - digits) above it.
+		*s = bc_num_ulong2num(&t, 20 * (unsigned long) err + 1);
+		if (*s) break;
+		bc_num_clean(&t);
+
+		if (top >= digits) {
+			*s = bc_num_shift(&t, top + 1 - digits);
+			if (*s) break;
+		}
+		else {
+			need = digits - 1 + zeros - top;
+			rdx = BC_NUM_RDX(need);
+			*s = bc_num_shift(&t, rdx * BC_BASE_DIGS - need);
+			if (*s) break;
+			t.rdx = rdx;
+			t.scale = need;
+		}
+
+		*s = bc_num_add(&lo, &t, &hi, 0);
+		if (*s) break;
+
+		if (!neg) {
+			if (lo.scale > scale) bc_num_truncate(&lo, lo.scale - scale);
+			if (hi.scale > scale) bc_num_truncate(&hi, hi.scale - scale);
+			done = !bc_num_cmp(&lo, &hi);
+			if (done) bc_num_copy(c, &lo);
+		}
+		else {
+			*s = bc_num_inv(&lo, c, scale);
+			if (!*s) *s = bc_num_inv(&hi, &t, scale);
+			done = !*s && !bc_num_cmp(c, &t);
+		}
+
+		digits *= 2;
+	}
+
+	if (!*s && done) {
+		if (c->scale < scale) bc_num_extend(c, scale - c->scale);
+		if (a->neg && (pow & 1) && c->len) c->neg = true;
+	}
+
+	bc_num_free(&t);
+	bc_num_free(&hi);
+	bc_num_free(&lo);
+
+	return *s || done;
+}
+
 BcStatus bc_num_p(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
 
 	BcStatus s = BC_STATUS_SUCCESS;
-	BcNum copy;
 	unsigned long pow;
-	size_t i, powrdx, resrdx;
-	bool neg, zero;
+	size_t i, up, down;
+	bool neg, zero, ten;
 
 	if (b->rdx) return BC_STATUS_MATH_NON_INTEGER;
 
@@ -636,59 +2654,178 @@ BcStatus bc_num_p(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
 	s = bc_num_ulong(b, &pow);
 	if (s) return s;
 
-	bc_num_init(&copy, a->len);
-	bc_num_copy(&copy, a);
-
-	if (!neg) scale = BC_MIN(a->rdx * pow, BC_MAX(scale, a->rdx));
+	if (!neg) scale = BC_MIN(a->scale * pow, BC_MAX(scale, a->scale));
 
 	b->neg = neg;
 
-	for (powrdx = a->rdx; !bcg.signe && !(pow & 1); pow >>= 1) {
-		powrdx <<= 1;
-		s = bc_num_mul(&copy, &copy, &copy, powrdx);
-		if (s) goto err;
+	// A power of ten only has one digit, wherever it ends up.
+	ten = !neg && a->len == 1 && bc_num_pow10Idx(a->num[0], &i);
+#if BC_NUM_BINARY
+	ten = ten && !a->bin;
+#endif // BC_NUM_BINARY
+
+	if (ten && pow < SIZE_MAX / 4 / (a->off + a->rdx + 1) / BC_BASE_DIGS) {
+		up = pow * (a->off * BC_BASE_DIGS + i);
+		down = pow * a->rdx * BC_BASE_DIGS;
+
+		if (down > up + scale) bc_num_setToZero(c, scale);
+		else {
+			bc_num_setToZero(c, scale);
+			c->rdx = BC_NUM_RDX(scale);
+			up += c->rdx * BC_BASE_DIGS - down;
+			c->num[0] = (BcDig) bc_num_pow10[up % BC_BASE_DIGS];
+			c->off = up / BC_BASE_DIGS;
+			c->len = 1;
+			c->neg = a->neg && (pow & 1);
+		}
+
+		return BC_STATUS_SUCCESS;
+	}
+
+	// When the exact power would have far more digits than are kept, it is
+	// only computed to as many as are needed.
+	if ((a->scale || neg) && bc_num_powTrunc(a, pow, neg, c, scale, &s))
+		return s;
+
+	s = bc_num_powWindow(a, pow, c, 0, NULL);
+	if (s) return s;
+
+	if (neg) {
+		s = bc_num_inv(c, c, scale);
+		if (s) return s;
+	}
+
+	if (c->scale > scale) bc_num_truncate(c, c->scale - scale);
+
+	// We can't use bc_num_clean() here.
+	for (zero = true, i = 0; zero && i < c->len; ++i) zero = !c->num[i];
+	if (zero) bc_num_setToZero(c, scale);
+
+	return s;
+}
+
+#if BC_NUM_BINARY
+BcStatus bc_num_binA(BcNum *a, BcNum *b, BcNum *restrict c, size_t sub) {
+
+	BcNum *temp;
+	ssize_t cmp;
+	bool neg = a->neg, bneg = !b->neg != !sub, add = neg == bneg;
+
+	// Because this function doesn't need to use scale (per the bc spec),
+	// I am hijacking it to say whether it's doing an add or a subtract.
+
+	if (a->len == 0) {
+		bc_num_copy(c, b);
+		if (sub && c->len) c->neg = !c->neg;
+		return BC_STATUS_SUCCESS;
+	}
+	else if (b->len == 0) {
+		bc_num_copy(c, a);
+		return BC_STATUS_SUCCESS;
+	}
+
+	cmp = bc_num_binCompare((BcBinDig*) a->num, a->len,
+	                        (BcBinDig*) b->num, b->len);
+
+	if (!add && cmp == 0) {
+		bc_num_setToZero(c, 0);
+		return BC_STATUS_SUCCESS;
+	}
+	else if (cmp < 0) {
+		if (!add) neg = bneg;
+		temp = a;
+		a = b;
+		b = temp;
 	}
 
-	if (bcg.signe) {
-		s = BC_STATUS_EXEC_SIGNAL;
-		goto err;
+	bc_num_expand(c, a->len + 1);
+	memcpy(c->num, a->num, a->len * sizeof(BcBinDig));
+	c->num[a->len] = 0;
+
+	if (add)
+		bc_num_binAddTo((BcBinDig*) c->num, a->len + 1,
+		                (BcBinDig*) b->num, b->len);
+	else
+		bc_num_binSubFrom((BcBinDig*) c->num, a->len,
+		                  (BcBinDig*) b->num, b->len);
+
+	bc_num_binRetire(c, a->len + 1, neg);
+
+	return BC_STATUS_SUCCESS;
+}
+
+BcStatus bc_num_binM(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+
+	BcBinDig *scratch = NULL, *bnum = (BcBinDig*) b->num;
+	size_t size;
+
+	(void) scale;
+
+	if (a->len == 0 || b->len == 0) {
+		bc_num_setToZero(c, 0);
+		return BC_STATUS_SUCCESS;
 	}
 
-	bc_num_copy(c, &copy);
+	size = bc_num_kScratch(BC_MAX(a->len, b->len));
+	if (size != 0) scratch = bc_vm_malloc(size * sizeof(BcBinDig));
 
-	for (resrdx = powrdx, pow >>= 1; !bcg.signe && pow != 0; pow >>= 1) {
+	// Squares are passed down as a times itself, like in bc_num_k().
+	if (a->len == b->len && !memcmp(a->num, bnum, a->len * sizeof(BcBinDig)))
+		bnum = (BcBinDig*) a->num;
 
-		powrdx <<= 1;
-		s = bc_num_mul(&copy, &copy, &copy, powrdx);
-		if (s) goto err;
+	bc_num_expand(c, a->len + b->len);
+	bc_num_binK((BcBinDig*) c->num, (BcBinDig*) a->num, a->len, bnum, b->len,
+	            scratch);
+	bc_num_binRetire(c, a->len + b->len, a->neg != b->neg);
 
-		if (pow & 1) {
-			resrdx += powrdx;
-			s = bc_num_mul(c, &copy, c, resrdx);
-			if (s) goto err;
-		}
+	free(scratch);
+
+	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+}
+
+BcStatus bc_num_binR(BcNum *a, BcNum *b, BcNum *restrict c, BcNum *restrict d)
+{
+	BcBinDig *q = NULL, *r = NULL;
+
+	if (b->len == 0) return BC_STATUS_MATH_DIVIDE_BY_ZERO;
+
+	if (bc_num_binCompare((BcBinDig*) a->num, a->len,
+	                      (BcBinDig*) b->num, b->len) < 0)
+	{
+		if (c) bc_num_setToZero(c, 0);
+		if (d) bc_num_copy(d, a);
+		return BC_STATUS_SUCCESS;
 	}
 
-	if (neg) {
-		s = bc_num_inv(c, c, scale);
-		if (s) goto err;
+	if (c) {
+		bc_num_expand(c, a->len - b->len + 1);
+		q = (BcBinDig*) c->num;
 	}
 
-	if (bcg.signe) {
-		s = BC_STATUS_EXEC_SIGNAL;
-		goto err;
+	if (d) {
+		bc_num_expand(d, b->len);
+		r = (BcBinDig*) d->num;
 	}
 
-	if (c->rdx > scale) bc_num_truncate(c, c->rdx - scale);
+	bc_num_binDivArrays((BcBinDig*) a->num, a->len, (BcBinDig*) b->num, b->len,
+	                    q, r);
 
-	// We can't use bc_num_clean() here.
-	for (zero = true, i = 0; zero && i < c->len; ++i) zero = !c->num[i];
-	if (zero) bc_num_setToZero(c, scale);
+	if (c) bc_num_binRetire(c, a->len - b->len + 1, a->neg != b->neg);
+	if (d) bc_num_binRetire(d, b->len, a->neg);
 
-err:
-	bc_num_free(&copy);
-	return s;
+	return bcg.signe ? BC_STATUS_EXEC_SIGNAL : BC_STATUS_SUCCESS;
+}
+
+BcStatus bc_num_binD(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+	(void) scale;
+	return bc_num_binR(a, b, c, NULL);
+}
+
+BcStatus bc_num_binRem(BcNum *a, BcNum *b, BcNum *restrict c, size_t scale) {
+	(void) scale;
+	return bc_num_binR(a, b, NULL, c);
 }
+#endif // BC_NUM_BINARY
 
 BcStatus bc_num_binary(BcNum *a, BcNum *b, BcNum *c, size_t scale,
                        BcNumBinaryOp op, size_t req)
@@ -757,9 +2894,20 @@ bool bc_num_strValid(const char *val, size_t base) {
 	return true;
 }
 
+// Returns the limb made of the len, at most BC_BASE_DIGS, decimal digits in val.
+BcDig bc_num_parseLimb(const char *val, size_t len) {
+
+	size_t i;
+	BcDig limb;
+
+	for (limb = 0, i = 0; i < len; ++i) limb = limb * 10 + (val[i] - '0');
+
+	return limb;
+}
+
 void bc_num_parseDecimal(BcNum *n, const char *val) {
 
-	size_t len, i;
+	size_t len, i, end, idx, ilen;
 	const char *ptr;
 	bool zero = true;
 
@@ -771,78 +2919,182 @@ void bc_num_parseDecimal(BcNum *n, const char *val) {
 
 	if (len != 0) {
 		for (i = 0; zero && i < len; ++i) zero = val[i] == '0' || val[i] == '.';
-		bc_num_expand(n, len);
+		bc_num_expand(n, BC_NUM_RDX(len) + 1);
 	}
 
 	ptr = strchr(val, '.');
 
 	// Explicitly test for NULL here to produce either a 0 or 1.
-	n->rdx = (size_t) ((ptr != NULL) * ((val + len) - (ptr + 1)));
+	n->scale = (size_t) ((ptr != NULL) * ((val + len) - (ptr + 1)));
+	n->rdx = BC_NUM_RDX(n->scale);
 
 	if (!zero) {
-		for (i = len - 1; i < len; ++n->len, i -= 1 + (i && val[i - 1] == '.'))
-			n->num[n->len] = val[i] - '0';
+
+		ilen = ptr ? (size_t) (ptr - val) : len;
+		n->len = n->rdx + BC_NUM_RDX(ilen);
+
+		// The integer digits are grouped into limbs from the radix up, so
+		// the top limb may be short.
+		for (i = 0, idx = n->len; i < ilen; i = end) {
+			end = i + (ilen - i - 1) % BC_BASE_DIGS + 1;
+			n->num[--idx] = bc_num_parseLimb(val + i, end - i);
+		}
+
+		// The fraction is grouped from the radix down and padded out to a
+		// whole limb.
+		for (i = 0; i < n->scale; i = end) {
+			end = BC_MIN(i + BC_BASE_DIGS, n->scale);
+			n->num[--idx] = bc_num_parseLimb(ptr + 1 + i, end - i) *
+			                (BcDig) bc_num_pow10[BC_BASE_DIGS - (end - i)];
+		}
+
+		bc_num_clean(n);
 	}
 }
 
-void bc_num_parseBase(BcNum *n, const char *val, BcNum *base) {
+// Sets n to the integer whose len digits in base base are in val. The digits
+// are read in groups small enough that base to the power of their length fits
+// in a limb, and each group is added to the limbs after they are multiplied by
+// that power.
+void bc_num_parseWords(BcNum *n, const char *val, size_t len,
+                       unsigned long base, size_t dig)
+{
+	BcBigDig carry, mul;
+	size_t i, j, end, nlen;
+	char c;
+
+	bc_num_zero(n);
+	bc_num_expand(n, len / dig + 1);
+
+	for (nlen = 0, i = 0; i < len;) {
+
+		// The first group is short if dig does not divide len.
+		end = i + (len - i - 1) % dig + 1;
+
+		for (carry = 0, mul = 1; i < end; ++i, mul *= base) {
+			c = val[i];
+			carry = carry * base + (BcBigDig) (c <= '9' ? c - '0' : c - 'A' + 10);
+		}
+
+		for (j = 0; j < nlen; ++j) {
+			carry += ((BcBigDig) n->num[j]) * mul;
+			n->num[j] = (BcDig) (carry % BC_BASE_POW);
+			carry /= BC_BASE_POW;
+		}
+
+		if (carry != 0) n->num[nlen++] = (BcDig) carry;
+	}
+
+	n->len = nlen;
+	bc_num_clean(n);
+}
 
+// Sets n to the integer whose len digits in base base are in val, where len is
+// no more than dig * 2^(i + 1). pows[i] is base^(dig * 2^i), and the top and
+// bottom digits are converted the same way and joined with one multiplication
+// by it.
+BcStatus bc_num_parseConv(BcNum *n, const char *val, size_t len, BcVec *pows,
+                          size_t i, unsigned long base, size_t dig)
+{
 	BcStatus s;
-	BcNum temp, mult, result;
-	BcDig c = '\0';
-	bool zero = true;
-	unsigned long v;
-	size_t i, digits, len = strlen(val);
+	BcNum hi, lo;
+	size_t half = dig << i;
 
-	bc_num_zero(n);
+	if (len <= dig * BC_NUM_PARSE_LEN) {
+		bc_num_parseWords(n, val, len, base, dig);
+		return BC_STATUS_SUCCESS;
+	}
 
-	for (i = 0; zero && i < len; ++i) zero = (val[i] == '.' || val[i] == '0');
-	if (zero) return;
+	if (len <= half) return bc_num_parseConv(n, val, len, pows, i - 1, base, dig);
 
-	bc_num_init(&temp, BC_NUM_DEF_SIZE);
-	bc_num_init(&mult, BC_NUM_DEF_SIZE);
+	bc_num_init(&hi, (len - half) / dig + 1);
+	bc_num_init(&lo, half / dig + 1);
 
-	for (i = 0; i < len; ++i) {
+	s = bc_num_parseConv(&hi, val, len - half, pows, i - 1, base, dig);
+	if (s) goto err;
+	s = bc_num_parseConv(&lo, val + len - half, half, pows, i - 1, base, dig);
+	if (s) goto err;
+
+	s = bc_num_mul(&hi, bc_vec_item(pows, i), n, 0);
+	if (s) goto err;
+	s = bc_num_add(n, &lo, n, 0);
+
+err:
+	bc_num_free(&lo);
+	bc_num_free(&hi);
+	return s;
+}
 
-		c = val[i];
-		if (c == '.') break;
+// Sets n to the integer whose len digits in base base are in val. Long strings
+// are split in halves, at powers of base^dig that are repeatedly squared, so the
+// work is in a few long multiplications instead of one for every digit.
+BcStatus bc_num_parseInt(BcNum *n, const char *val, size_t len,
+                         unsigned long base)
+{
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum pow, *p;
+	BcVec pows;
+	BcBigDig b;
+	size_t i, dig;
 
-		v = (unsigned long) (c <= '9' ? c - '0' : c - 'A' + 10);
+	for (b = base, dig = 1; b * base < BC_BASE_POW; ++dig) b *= base;
 
-		s = bc_num_mul(n, base, &mult, 0);
-		if (s) goto int_err;
-		s = bc_num_ulong2num(&temp, v);
-		if (s) goto int_err;
-		s = bc_num_add(&mult, &temp, n, 0);
-		if (s) goto int_err;
+	if (len <= dig * BC_NUM_PARSE_LEN) {
+		bc_num_parseWords(n, val, len, base, dig);
+		return BC_STATUS_SUCCESS;
 	}
 
-	if (i == len) {
-		c = val[i];
-		if (c == 0) goto int_err;
+	bc_vec_init(&pows, sizeof(BcNum), bc_num_free);
+	bc_num_init(&pow, BC_NUM_DEF_SIZE);
+	bc_vec_push(&pows, &pow);
+
+	s = bc_num_ulong2num(bc_vec_item(&pows, 0), (unsigned long) b);
+	if (s) goto err;
+
+	for (i = 0, p = bc_vec_item(&pows, 0); !s && (dig << (i + 1)) < len; ++i) {
+		bc_num_init(&pow, 2 * p->len);
+		s = bc_num_mul(p, p, &pow, 0);
+		bc_vec_push(&pows, &pow);
+		p = bc_vec_item(&pows, i + 1);
 	}
 
-	assert(c == '.');
-	bc_num_init(&result, base->len);
-	bc_num_zero(&result);
-	bc_num_one(&mult);
+	if (!s) s = bc_num_parseConv(n, val, len, &pows, i, base, dig);
+
+err:
+	bc_vec_free(&pows);
+	return s;
+}
+
+void bc_num_parseBase(BcNum *n, const char *val, BcNum *base, size_t base_t) {
 
-	for (i += 1, digits = 0; i < len; ++i, ++digits) {
+	BcStatus s;
+	BcNum mult, result;
+	bool zero = true;
+	const char *ptr;
+	size_t i, digits, len = strlen(val);
 
-		c = val[i];
-		if (c == 0) break;
+	bc_num_zero(n);
 
-		v = (unsigned long) (c <= '9' ? c - '0' : c - 'A' + 10);
+	for (i = 0; zero && i < len; ++i) zero = (val[i] == '.' || val[i] == '0');
+	if (zero) return;
 
-		s = bc_num_mul(&result, base, &result, 0);
-		if (s) goto err;
-		s = bc_num_ulong2num(&temp, v);
-		if (s) goto err;
-		s = bc_num_add(&result, &temp, &result, 0);
-		if (s) goto err;
-		s = bc_num_mul(&mult, base, &mult, 0);
-		if (s) goto err;
-	}
+	ptr = strchr(val, '.');
+	i = ptr ? (size_t) (ptr - val) : len;
+
+	s = bc_num_parseInt(n, val, i, base_t);
+	if (s || !ptr) return;
+
+	digits = len - i - 1;
+
+	bc_num_init(&mult, BC_NUM_DEF_SIZE);
+	bc_num_init(&result, BC_NUM_DEF_SIZE);
+
+	s = bc_num_parseInt(&result, ptr + 1, digits, base_t);
+	if (s) goto err;
+
+	if (digits) s = bc_num_powWindow(base, digits, &mult, 0, NULL);
+	else bc_num_one(&mult);
+	if (s) goto err;
 
 	s = bc_num_div(&result, &mult, &result, digits);
 	if (s) goto err;
@@ -850,17 +3102,65 @@ void bc_num_parseBase(BcNum *n, const char *val, BcNum *base) {
 	if (s) goto err;
 
 	if (n->len != 0) {
-		if (n->rdx < digits) bc_num_extend(n, digits - n->rdx);
+		if (n->scale < digits) bc_num_extend(n, digits - n->scale);
 	}
 	else bc_num_zero(n);
 
 err:
 	bc_num_free(&result);
-int_err:
 	bc_num_free(&mult);
-	bc_num_free(&temp);
 }
 
+#if BC_NUM_BINARY
+void bc_num_parseBin(BcNum *n, const char *val, size_t base_t) {
+
+	BcBinDig *a, dig, pow;
+	size_t i, j, bits, len, alen;
+	char c;
+
+	for (; *val == '0'; ++val);
+	len = strlen(val);
+
+	bc_num_zero(n);
+	if (!len) return;
+
+	// Each digit is at most 4 bits.
+	alen = (len + 7) / 8 + 1;
+	bc_num_expand(n, alen);
+	a = (BcBinDig*) n->num;
+
+	if (!(base_t & (base_t - 1))) {
+
+		for (bits = 0; (1UL << bits) < base_t; ++bits);
+		memset(a, 0, alen * sizeof(BcBinDig));
+
+		for (i = 0; i < len; ++i) {
+			c = val[len - 1 - i];
+			dig = (BcBinDig) (c <= '9' ? c - '0' : c - 'A' + 10);
+			j = i * bits;
+			a[j / 32] |= dig << (j % 32);
+			if (j % 32 + bits > 32) a[j / 32 + 1] |= dig >> (32 - j % 32);
+		}
+	}
+	else {
+
+		for (alen = 0, i = 0; i < len;) {
+
+			for (dig = 0, pow = 1; i < len && pow <= UINT32_MAX / base_t; ++i) {
+				c = val[i];
+				dig = dig * (BcBinDig) base_t +
+				      (BcBinDig) (c <= '9' ? c - '0' : c - 'A' + 10);
+				pow *= (BcBinDig) base_t;
+			}
+
+			alen = bc_num_binMulAdd(a, alen, pow, dig);
+		}
+	}
+
+	bc_num_binRetire(n, alen, false);
+}
+#endif // BC_NUM_BINARY
+
 void bc_num_printNewline(size_t *nchars, size_t line_len) {
 	if (*nchars == line_len - 1) {
 		bc_vm_putchar('\\');
@@ -869,126 +3169,416 @@ void bc_num_printNewline(size_t *nchars, size_t line_len) {
 	}
 }
 
-#ifdef DC_ENABLED
-void bc_num_printChar(size_t num, size_t width, bool radix,
-                      size_t *nchars, size_t line_len)
-{
-	(void) radix, (void) line_len;
-	bc_vm_putchar((char) num);
-	*nchars = *nchars + width;
+#ifdef DC_ENABLED
+void bc_num_printChar(size_t num, size_t width, bool radix,
+                      size_t *nchars, size_t line_len)
+{
+	(void) radix, (void) line_len;
+	bc_vm_putchar((char) num);
+	*nchars = *nchars + width;
+}
+#endif // DC_ENABLED
+
+void bc_num_printDigits(size_t num, size_t width, bool radix,
+                        size_t *nchars, size_t line_len)
+{
+	size_t exp, pow, div;
+
+	bc_num_printNewline(nchars, line_len);
+	bc_vm_putchar(radix ? '.' : ' ');
+	++(*nchars);
+
+	bc_num_printNewline(nchars, line_len);
+	for (exp = 0, pow = 1; exp < width - 1; ++exp, pow *= 10);
+
+	for (exp = 0; exp < width; pow /= 10, ++(*nchars), ++exp) {
+		bc_num_printNewline(nchars, line_len);
+		div = num / pow;
+		num -= div * pow;
+		bc_vm_putchar(((char) div) + '0');
+	}
+}
+
+void bc_num_printHex(size_t num, size_t width, bool radix,
+                     size_t *nchars, size_t line_len)
+{
+	assert(width == 1);
+
+	if (radix) {
+		bc_num_printNewline(nchars, line_len);
+		bc_vm_putchar('.');
+		*nchars += 1;
+	}
+
+	bc_num_printNewline(nchars, line_len);
+	bc_vm_putchar(bc_num_hex_digits[num]);
+	*nchars = *nchars + width;
+}
+
+// Writes the len characters in str, breaking lines like bc_num_printNewline()
+// does, but a line at a time instead of a character at a time.
+void bc_num_printChars(const char *str, size_t len, size_t *nchars,
+                       size_t line_len)
+{
+	size_t room;
+
+	while (len) {
+
+		bc_num_printNewline(nchars, line_len);
+
+		room = *nchars < line_len - 1 ? line_len - 1 - *nchars : len;
+		room = BC_MIN(room, len);
+
+		bc_vm_write(str, room);
+		*nchars += room;
+		str += room;
+		len -= room;
+	}
+}
+
+void bc_num_printDecimal(BcNum *n, size_t *nchars, size_t len) {
+
+	size_t i, j, end, blen, rdx = n->rdx, top = BC_MAX(BC_NUM_TOP(n), rdx);
+	char buf[BC_NUM_PRINT_BUF], digs[BC_BASE_DIGS];
+	BcDig limb;
+	bool zero = true;
+
+	if (n->neg) bc_vm_putchar('-');
+	(*nchars) += n->neg;
+
+	for (blen = 0, i = top - 1; i < top; --i) {
+
+		// Only the digits above the scale are printed from the last limb.
+		end = i == 0 ? n->scale % BC_BASE_DIGS : 0;
+		end = end ? BC_BASE_DIGS - end : 0;
+		limb = bc_num_limb(n, i);
+
+		for (j = BC_BASE_DIGS; j > 0; --j, limb /= 10)
+			digs[j - 1] = (char) ('0' + limb % 10);
+
+		if (i + 1 == rdx) {
+			buf[blen++] = '.';
+			zero = false;
+		}
+
+		for (j = 0; zero && j < BC_BASE_DIGS && digs[j] == '0'; ++j);
+		zero = zero && j == BC_BASE_DIGS;
+
+		for (; j < BC_BASE_DIGS - end; ++j) buf[blen++] = digs[j];
+
+		if (blen > BC_NUM_PRINT_BUF - BC_BASE_DIGS - 1) {
+			bc_num_printChars(buf, blen, nchars, len);
+			blen = 0;
+		}
+	}
+
+	bc_num_printChars(buf, blen, nchars, len);
+}
+
+#if BC_NUM_BINARY
+BcStatus bc_num_printBin(BcNum *n, BcNum *base, size_t width, size_t *nchars,
+                         size_t len, BcNumDigitOp print)
+{
+	BcStatus s;
+	BcVec stack;
+	BcBinDig *a, pow, dig;
+	unsigned long base_t, d, *ptr;
+	size_t i, j, k, alen = n->len;
+
+	s = bc_num_ulong(base, &base_t);
+	if (s) return s;
+
+	bc_vec_init(&stack, sizeof(long), NULL);
+	a = (BcBinDig*) n->num;
+
+	if (!(base_t & (base_t - 1))) {
+
+		for (k = 0; (1UL << k) < base_t; ++k);
+
+		for (i = 0; i < alen * 32; i += k) {
+			j = i % 32;
+			dig = a[i / 32] >> j;
+			if (j + k > 32 && i / 32 + 1 < alen)
+				dig |= a[i / 32 + 1] << (32 - j);
+			d = dig & (base_t - 1);
+			bc_vec_push(&stack, &d);
+		}
+
+		while (*((unsigned long*) bc_vec_item_rev(&stack, 0)) == 0)
+			bc_vec_pop(&stack);
+	}
+	else {
+
+		a = bc_vm_malloc(alen * sizeof(BcBinDig));
+		memcpy(a, n->num, alen * sizeof(BcBinDig));
+
+		for (pow = base_t, k = 1; pow <= UINT32_MAX / base_t; ++k)
+			pow *= base_t;
+
+		while (alen != 0 && !bcg.signe) {
+
+			dig = bc_num_binDivWord(a, alen, pow);
+			alen = bc_num_binLen(a, alen);
+
+			for (j = 0; j < k && (alen != 0 || dig != 0); ++j) {
+				d = dig % base_t;
+				bc_vec_push(&stack, &d);
+				dig /= base_t;
+			}
+		}
+
+		free(a);
+
+		if (bcg.signe) {
+			s = BC_STATUS_EXEC_SIGNAL;
+			goto err;
+		}
+	}
+
+	for (i = 0; i < stack.len; ++i) {
+		ptr = bc_vec_item_rev(&stack, i);
+		assert(ptr);
+		print(*ptr, width, false, nchars, len);
+	}
+
+err:
+	bc_vec_free(&stack);
+	return s;
+}
+#endif // BC_NUM_BINARY
+
+// Pushes the digits of the integer n in base base onto digs, most significant
+// first. If pad is not 0, there are exactly pad of them; otherwise, there are
+// no leading zeros. pow is base^dig, the largest power below BC_BASE_POW.
+BcStatus bc_num_convWords(BcNum *n, unsigned long base, BcBigDig pow,
+                          size_t dig, size_t pad, BcVec *digs)
+{
+	BcDig *t;
+	BcBigDig rem;
+	unsigned long d, *a, *b;
+	size_t i, j, len = BC_NUM_TOP(n), start = digs->len;
+
+	t = bc_vm_malloc((len + 1) * sizeof(BcDig));
+	memset(t, 0, n->off * sizeof(BcDig));
+	memcpy(t + n->off, n->num, n->len * sizeof(BcDig));
+
+	while (len && !t[len - 1]) --len;
+
+	// The digits come out least significant first, and are reversed after.
+	while (len && !bcg.signe) {
+
+		for (rem = 0, i = len - 1; i < len; --i) {
+			rem = rem * BC_BASE_POW + (BcBigDig) t[i];
+			t[i] = (BcDig) (rem / pow);
+			rem %= pow;
+		}
+
+		while (len && !t[len - 1]) --len;
+
+		for (j = 0; j < dig && (len || rem); ++j) {
+			d = (unsigned long) (rem % base);
+			bc_vec_push(digs, &d);
+			rem /= base;
+		}
+	}
+
+	free(t);
+
+	if (bcg.signe) return BC_STATUS_EXEC_SIGNAL;
+
+	assert(!pad || digs->len - start <= pad);
+
+	for (d = 0; digs->len - start < pad;) bc_vec_push(digs, &d);
+
+	for (i = start, j = digs->len; i + 1 < j; ++i, --j) {
+		a = bc_vec_item(digs, i);
+		b = bc_vec_item(digs, j - 1);
+		d = *a;
+		*a = *b;
+		*b = d;
+	}
+
+	return BC_STATUS_SUCCESS;
+}
+
+// Pushes the digits of the integer n, which is less than pows[i]^2, onto digs
+// like bc_num_convWords() does. pows[i] is base^(dig * 2^i), and n is divided
+// by it into its top and bottom halves, which are converted the same way.
+BcStatus bc_num_conv(BcNum *n, BcVec *pows, size_t i, unsigned long base,
+                     size_t dig, size_t pad, BcVec *digs)
+{
+	BcStatus s;
+	BcNum q, r, *pow = bc_vec_item(pows, 0);
+	size_t half = dig << i;
+
+	if (BC_NUM_TOP(n) <= BC_NUM_PRINT_LEN)
+		return bc_num_convWords(n, base, (BcBigDig) pow->num[0], dig, pad,
+		                        digs);
+
+	// n is less than base^pad, so it has no top half.
+	if (pad && pad <= half)
+		return bc_num_conv(n, pows, i - 1, base, dig, pad, digs);
+
+	pow = bc_vec_item(pows, i);
+
+	bc_num_init(&q, n->len);
+	bc_num_init(&r, pow->len);
+
+	s = bc_num_divmod(n, pow, &q, &r, 0);
+	if (s) goto err;
+
+	if (q.len || pad) {
+		s = bc_num_conv(&q, pows, i - 1, base, dig, pad ? pad - half : 0, digs);
+		if (s) goto err;
+		pad = half;
+	}
+
+	s = bc_num_conv(&r, pows, i - 1, base, dig, pad, digs);
+
+err:
+	bc_num_free(&r);
+	bc_num_free(&q);
+	return s;
 }
-#endif // DC_ENABLED
 
-void bc_num_printDigits(size_t num, size_t width, bool radix,
-                        size_t *nchars, size_t line_len)
+// Pushes the digits of the integer n in base base onto digs, padded to pad
+// digits like bc_num_convWords() does. Long integers are split in halves by
+// powers of base^dig, repeatedly squared, so the divisions are by few long
+// numbers instead of many short ones.
+BcStatus bc_num_convInt(BcNum *n, unsigned long base, size_t pad,
+                        BcVec *digs)
 {
-	size_t exp, pow, div;
 
-	bc_num_printNewline(nchars, line_len);
-	bc_vm_putchar(radix ? '.' : ' ');
-	++(*nchars);
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum pow, *p;
+	BcVec pows;
+	BcBigDig b;
+	size_t i, dig;
 
-	bc_num_printNewline(nchars, line_len);
-	for (exp = 0, pow = 1; exp < width - 1; ++exp, pow *= 10);
+	for (b = base, dig = 1; b * base < BC_BASE_POW; ++dig) b *= base;
 
-	for (exp = 0; exp < width; pow /= 10, ++(*nchars), ++exp) {
-		bc_num_printNewline(nchars, line_len);
-		div = num / pow;
-		num -= div * pow;
-		bc_vm_putchar(((char) div) + '0');
+	bc_vec_init(&pows, sizeof(BcNum), bc_num_free);
+	bc_num_init(&pow, BC_NUM_DEF_SIZE);
+	bc_vec_push(&pows, &pow);
+
+	s = bc_num_ulong2num(bc_vec_item(&pows, 0), (unsigned long) b);
+	if (s) goto err;
+
+	// pows[i]^2 is more than n once pows[i] has more than half its limbs.
+	for (i = 0, p = bc_vec_item(&pows, 0);
+	     2 * (BC_NUM_TOP(p) - 1) < BC_NUM_TOP(n) && !s; ++i)
+	{
+		bc_num_init(&pow, 2 * p->len);
+		s = bc_num_mul(p, p, &pow, 0);
+		bc_vec_push(&pows, &pow);
+		p = bc_vec_item(&pows, i + 1);
 	}
+
+	if (!s) s = bc_num_conv(n, &pows, i, base, dig, pad, digs);
+
+err:
+	bc_vec_free(&pows);
+	return s;
 }
 
-void bc_num_printHex(size_t num, size_t width, bool radix,
-                     size_t *nchars, size_t line_len)
+// Pushes the digits in base base of the fraction n, which has scale decimal
+// places, onto digs. There is one digit for every power of base, starting at
+// 1, with no more than scale integer digits, and since n times a power of base
+// has no more than scale places, they are the digits of n * base^len, rounded
+// down, where len is how many there are. len is found by multiplying by powers
+// of base that keep the product below 10^scale, since base^dig is below
+// BC_BASE_POW.
+BcStatus bc_num_convFrac(BcNum *n, BcNum *base, unsigned long b, size_t scale,
+                         BcVec *digs)
 {
-	assert(width == 1);
+	BcStatus s = BC_STATUS_SUCCESS;
+	BcNum pow, t;
+	BcBigDig p;
+	size_t dig, len, step, digits;
 
-	if (radix) {
-		bc_num_printNewline(nchars, line_len);
-		bc_vm_putchar('.');
-		*nchars += 1;
-	}
+	for (p = b, dig = 1; p * b < BC_BASE_POW; ++dig) p *= b;
 
-	bc_num_printNewline(nchars, line_len);
-	bc_vm_putchar(bc_num_hex_digits[num]);
-	*nchars = *nchars + width;
-}
+	bc_num_init(&pow, BC_NUM_RDX(scale) + 1);
+	bc_num_init(&t, BC_NUM_DEF_SIZE);
+	bc_num_one(&pow);
 
-void bc_num_printDecimal(BcNum *n, size_t *nchars, size_t len) {
+	for (len = 0; !s && (digits = bc_num_intDigits(&pow)) <= scale; len += step)
+	{
+		step = (scale - digits) * dig / BC_BASE_DIGS;
+		if (!step) step = 1;
+		s = bc_num_powWindow(base, step, &t, 0, NULL);
+		if (!s) s = bc_num_mul(&pow, &t, &pow, 0);
+	}
 
-	size_t i, rdx = n->rdx - 1;
+	if (s) goto err;
 
-	if (n->neg) bc_vm_putchar('-');
-	(*nchars) += n->neg;
+	s = bc_num_mul(n, &pow, &t, 0);
+	if (s) goto err;
+	bc_num_truncate(&t, t.scale);
 
-	for (i = n->len - 1; i < n->len; --i)
-		bc_num_printHex((size_t) n->num[i], 1, i == rdx, nchars, len);
+	s = bc_num_convInt(&t, b, len, digs);
+
+err:
+	bc_num_free(&t);
+	bc_num_free(&pow);
+	return s;
 }
 
 BcStatus bc_num_printNum(BcNum *n, BcNum *base, size_t width, size_t *nchars,
                          size_t len, BcNumDigitOp print)
 {
 	BcStatus s;
-	BcVec stack;
-	BcNum intp, fracp, digit, frac_len;
+	BcVec digs;
+	BcNum intp, fracp;
 	unsigned long dig, *ptr;
 	size_t i;
-	bool radix;
 
 	if (n->len == 0) {
 		print(0, width, false, nchars, len);
 		return BC_STATUS_SUCCESS;
 	}
 
-	bc_vec_init(&stack, sizeof(long), NULL);
+#if BC_NUM_BINARY
+	if (n->bin) return bc_num_printBin(n, base, width, nchars, len, print);
+	bc_num_toDec(base);
+#endif // BC_NUM_BINARY
+
+	bc_vec_init(&digs, sizeof(long), NULL);
 	bc_num_init(&intp, n->len);
 	bc_num_init(&fracp, n->rdx);
-	bc_num_init(&digit, width);
-	bc_num_init(&frac_len, BC_NUM_INT(n));
 	bc_num_copy(&intp, n);
-	bc_num_one(&frac_len);
 
-	bc_num_truncate(&intp, intp.rdx);
+	bc_num_truncate(&intp, intp.scale);
 	s = bc_num_sub(n, &intp, &fracp, 0);
 	if (s) goto err;
 
-	while (intp.len != 0) {
-		s = bc_num_divmod(&intp, base, &intp, &digit, 0);
-		if (s) goto err;
-		s = bc_num_ulong(&digit, &dig);
-		if (s) goto err;
-		bc_vec_push(&stack, &dig);
-	}
+	s = bc_num_ulong(base, &dig);
+	if (s) goto err;
+	s = bc_num_convInt(&intp, dig, 0, &digs);
+	if (s) goto err;
 
-	for (i = 0; i < stack.len; ++i) {
-		ptr = bc_vec_item_rev(&stack, i);
+	for (i = 0; i < digs.len; ++i) {
+		ptr = bc_vec_item(&digs, i);
 		assert(ptr);
 		print(*ptr, width, false, nchars, len);
 	}
 
-	if (!n->rdx) goto err;
+	if (!n->scale) goto err;
 
-	for (radix = true; frac_len.len <= n->rdx; radix = false) {
-		s = bc_num_mul(&fracp, base, &fracp, n->rdx);
-		if (s) goto err;
-		s = bc_num_ulong(&fracp, &dig);
-		if (s) goto err;
-		s = bc_num_ulong2num(&intp, dig);
-		if (s) goto err;
-		s = bc_num_sub(&fracp, &intp, &fracp, 0);
-		if (s) goto err;
-		print(dig, width, radix, nchars, len);
-		s = bc_num_mul(&frac_len, base, &frac_len, 0);
-		if (s) goto err;
+	bc_vec_npop(&digs, digs.len);
+	s = bc_num_convFrac(&fracp, base, dig, n->scale, &digs);
+	if (s) goto err;
+
+	for (i = 0; i < digs.len; ++i) {
+		ptr = bc_vec_item(&digs, i);
+		assert(ptr);
+		print(*ptr, width, i == 0, nchars, len);
 	}
 
 err:
-	bc_num_free(&frac_len);
-	bc_num_free(&digit);
 	bc_num_free(&fracp);
 	bc_num_free(&intp);
-	bc_vec_free(&stack);
+	bc_vec_free(&digs);
 	return s;
 }
 
@@ -1030,7 +3620,9 @@ void bc_num_init(BcNum *n, size_t req) {
 	assert(n);
 	req = req >= BC_NUM_DEF_SIZE ? req : BC_NUM_DEF_SIZE;
 	memset(n, 0, sizeof(BcNum));
-	n->num = bc_vm_malloc(req);
+	if (req == BC_NUM_DEF_SIZE && bcg.pool.len)
+		n->num = bcg.pool.nums[--bcg.pool.len];
+	else n->num = bc_vm_malloc(req * sizeof(BcDig));
 	n->cap = req;
 }
 
@@ -1038,14 +3630,39 @@ void bc_num_expand(BcNum *n, size_t req) {
 	assert(n);
 	req = req >= BC_NUM_DEF_SIZE ? req : BC_NUM_DEF_SIZE;
 	if (req > n->cap) {
-		n->num = bc_vm_realloc(n->num, req);
+		n->num = bc_vm_realloc(n->num, req * sizeof(BcDig));
 		n->cap = req;
 	}
 }
 
+// Returns true if the limbs at num are in the pool.
+bool bc_num_pooled(BcDig *num) {
+
+	size_t i;
+
+	for (i = 0; i < bcg.pool.len && bcg.pool.nums[i] != num; ++i);
+
+	return i < bcg.pool.len;
+}
+
 void bc_num_free(void *num) {
+
+	BcNum *n = (BcNum*) num;
+
+	// Only numbers from bc_num_init() may be freed, so their limbs are on the
+	// heap with room for at least BC_NUM_DEF_SIZE; views into other numbers and
+	// limbs on the stack would otherwise end up in the pool. dc's strings have
+	// no limbs at all.
 	assert(num);
-	free(((BcNum*) num)->num);
+	assert(!n->num || (n->cap >= BC_NUM_DEF_SIZE && !bc_num_pooled(n->num)));
+
+	if (n->cap == BC_NUM_DEF_SIZE && bcg.pool.len < BC_NUM_POOL_LEN)
+		bcg.pool.nums[bcg.pool.len++] = n->num;
+	else free(n->num);
+}
+
+void bc_num_poolFree(BcNumPool *pool) {
+	while (pool->len) free(pool->nums[--pool->len]);
 }
 
 void bc_num_copy(BcNum *d, BcNum *s) {
@@ -1057,6 +3674,11 @@ void bc_num_copy(BcNum *d, BcNum *s) {
 		d->len = s->len;
 		d->neg = s->neg;
 		d->rdx = s->rdx;
+		d->scale = s->scale;
+		d->off = s->off;
+#if BC_NUM_BINARY
+		d->bin = s->bin;
+#endif // BC_NUM_BINARY
 		memcpy(d->num, s->num, sizeof(BcDig) * d->len);
 	}
 }
@@ -1068,8 +3690,16 @@ BcStatus bc_num_parse(BcNum *n, const char *val, BcNum *base, size_t base_t) {
 
 	if (!bc_num_strValid(val, base_t)) return BC_STATUS_MATH_BAD_STRING;
 
+#if BC_NUM_BINARY
+	if (!strchr(val, '.') && (!(base_t & (base_t - 1)) ||
+	                          strlen(val) <= BC_BASE_DIGS * BC_NUM_BIN_LEN))
+	{
+		bc_num_parseBin(n, val, base_t);
+	}
+	else
+#endif // BC_NUM_BINARY
 	if (base_t == 10) bc_num_parseDecimal(n, val);
-	else bc_num_parseBase(n, val, base);
+	else bc_num_parseBase(n, val, base, base_t);
 
 	return BC_STATUS_SUCCESS;
 }
@@ -1088,7 +3718,12 @@ BcStatus bc_num_print(BcNum *n, BcNum *base, size_t base_t, bool newline,
 		bc_vm_putchar('0');
 		++(*nchars);
 	}
-	else if (base_t == 10) bc_num_printDecimal(n, nchars, line_len);
+	else if (base_t == 10) {
+#if BC_NUM_BINARY
+		bc_num_toDec(n);
+#endif // BC_NUM_BINARY
+		bc_num_printDecimal(n, nchars, line_len);
+	}
 	else s = bc_num_printBase(n, base, base_t, nchars, line_len);
 
 	if (newline) {
@@ -1102,20 +3737,38 @@ BcStatus bc_num_print(BcNum *n, BcNum *base, size_t base_t, bool newline,
 BcStatus bc_num_ulong(BcNum *n, unsigned long *result) {
 
 	size_t i;
-	unsigned long pow;
+	unsigned long prev;
+#if BC_NUM_BINARY
+	BcBinDig *w;
+	BcBigDig big;
+#endif // BC_NUM_BINARY
 
 	assert(n && result);
 
 	if (n->neg) return BC_STATUS_MATH_NEGATIVE;
 
-	for (*result = 0, pow = 1, i = n->rdx; i < n->len; ++i) {
+#if BC_NUM_BINARY
+	if (n->bin) {
+
+		if (n->len > 2) return BC_STATUS_MATH_OVERFLOW;
+
+		w = (BcBinDig*) n->num;
+		big = n->len == 2 ? ((BcBigDig) w[1]) << 32 | w[0] : w[0];
+		if (big > ULONG_MAX) return BC_STATUS_MATH_OVERFLOW;
+
+		*result = (unsigned long) big;
 
-		unsigned long prev = *result, powprev = pow;
+		return BC_STATUS_SUCCESS;
+	}
+#endif // BC_NUM_BINARY
 
-		*result += ((unsigned long) n->num[i]) * pow;
-		pow *= 10;
+	for (*result = 0, i = BC_NUM_TOP(n); i > n->rdx; --i) {
 
-		if (*result < prev || pow < powprev) return BC_STATUS_MATH_OVERFLOW;
+		prev = *result * BC_BASE_POW;
+		if (prev / BC_BASE_POW != *result) return BC_STATUS_MATH_OVERFLOW;
+
+		*result = prev + (unsigned long) bc_num_limb(n, i - 1);
+		if (*result < prev) return BC_STATUS_MATH_OVERFLOW;
 	}
 
 	return BC_STATUS_SUCCESS;
@@ -1133,145 +3786,279 @@ BcStatus bc_num_ulong2num(BcNum *n, unsigned long val) {
 
 	if (val == 0) return BC_STATUS_SUCCESS;
 
-	for (len = 1, i = ULONG_MAX; i != 0; i /= 10, ++len)
+	for (len = 1, i = ULONG_MAX; i >= BC_BASE_POW; i /= BC_BASE_POW, ++len);
 	bc_num_expand(n, len);
-	for (ptr = n->num, i = 0; val; ++i, ++n->len, val /= 10) ptr[i] = val % 10;
+	for (ptr = n->num, i = 0; val; ++i, ++n->len, val /= BC_BASE_POW)
+		ptr[i] = (BcDig) (val % BC_BASE_POW);
 
 	return BC_STATUS_SUCCESS;
 }
 
+// Sets x to the magnitude of n and returns true if n is an integer of no more
+// than two limbs, which is small enough that sums, differences and quotients
+// of such integers can be done in a BcBigDig.
+bool bc_num_word(BcNum *n, BcBigDig *x) {
+
+#if BC_NUM_BINARY
+	if (n->bin) return false;
+#endif // BC_NUM_BINARY
+
+	if (n->scale || BC_NUM_TOP(n) > 2) return false;
+
+	*x = ((BcBigDig) bc_num_limb(n, 1)) * BC_BASE_POW +
+	     (BcBigDig) bc_num_limb(n, 0);
+
+	return true;
+}
+
+// Sets n to the integer x, negative if neg.
+void bc_num_setWord(BcNum *n, BcBigDig x, bool neg) {
+
+	bc_num_zero(n);
+
+	// Every number has room for at least BC_NUM_DEF_SIZE limbs.
+	for (; x; x /= BC_BASE_POW) n->num[n->len++] = (BcDig) (x % BC_BASE_POW);
+
+	n->neg = neg && n->len;
+	bc_num_clean(n);
+}
+
+// The functions below do an operation with machine words if both operands fit
+// in them (see bc_num_word()) and return whether they did.
+
+bool bc_num_wordAdd(BcNum *a, BcNum *b, BcNum *c, bool sub) {
+
+	BcBigDig x, y;
+	bool neg = b->neg != sub;
+
+	if (!bc_num_word(a, &x) || !bc_num_word(b, &y)) return false;
+
+	if (a->neg == neg) bc_num_setWord(c, x + y, neg);
+	else if (x >= y) bc_num_setWord(c, x - y, a->neg);
+	else bc_num_setWord(c, y - x, neg);
+
+	return true;
+}
+
+bool bc_num_wordMul(BcNum *a, BcNum *b, BcNum *c) {
+
+	BcBigDig x, y;
+
+	if (!bc_num_word(a, &x) || !bc_num_word(b, &y)) return false;
+	if (y && x > UINT64_MAX / y) return false;
+
+	bc_num_setWord(c, x * y, a->neg != b->neg);
+
+	return true;
+}
+
+// Only quotients and remainders with a scale of 0 are integers.
+bool bc_num_wordDiv(BcNum *a, BcNum *b, BcNum *c, size_t scale, bool rem) {
+
+	BcBigDig x, y;
+
+	if (scale || !bc_num_word(a, &x) || !bc_num_word(b, &y) || !y)
+		return false;
+
+	if (rem) bc_num_setWord(c, x % y, a->neg);
+	else bc_num_setWord(c, x / y, a->neg != b->neg);
+
+	return true;
+}
+
 BcStatus bc_num_add(BcNum *a, BcNum *b, BcNum *c, size_t scale) {
 	BcNumBinaryOp op = (!a->neg == !b->neg) ? bc_num_a : bc_num_s;
 	(void) scale;
+	if (bc_num_wordAdd(a, b, c, false)) return BC_STATUS_SUCCESS;
+#if BC_NUM_BINARY
+	if (bc_num_useBin(a, b, !a->scale && !b->scale)) op = bc_num_binA;
+#endif // BC_NUM_BINARY
 	return bc_num_binary(a, b, c, false, op, BC_NUM_AREQ(a, b));
 }
 
 BcStatus bc_num_sub(BcNum *a, BcNum *b, BcNum *c, size_t scale) {
 	BcNumBinaryOp op = (!a->neg == !b->neg) ? bc_num_s : bc_num_a;
 	(void) scale;
+	if (bc_num_wordAdd(a, b, c, true)) return BC_STATUS_SUCCESS;
+#if BC_NUM_BINARY
+	if (bc_num_useBin(a, b, !a->scale && !b->scale)) op = bc_num_binA;
+#endif // BC_NUM_BINARY
 	return bc_num_binary(a, b, c, true, op, BC_NUM_AREQ(a, b));
 }
 
 BcStatus bc_num_mul(BcNum *a, BcNum *b, BcNum *c, size_t scale) {
-	size_t req = BC_NUM_MREQ(a, b, scale);
-	return bc_num_binary(a, b, c, scale, bc_num_m, req);
+	BcNumBinaryOp op = bc_num_m;
+	if (bc_num_wordMul(a, b, c)) return BC_STATUS_SUCCESS;
+#if BC_NUM_BINARY
+	if (bc_num_useBin(a, b, !a->scale && !b->scale)) op = bc_num_binM;
+#endif // BC_NUM_BINARY
+	return bc_num_binary(a, b, c, scale, op, BC_NUM_MREQ(a, b));
 }
 
 BcStatus bc_num_div(BcNum *a, BcNum *b, BcNum *c, size_t scale) {
-	size_t req = BC_NUM_MREQ(a, b, scale);
-	return bc_num_binary(a, b, c, scale, bc_num_d, req);
+	BcNumBinaryOp op = bc_num_d;
+	if (bc_num_wordDiv(a, b, c, scale, false)) return BC_STATUS_SUCCESS;
+#if BC_NUM_BINARY
+	if (bc_num_useBin(a, b, !scale && !a->scale && !b->scale)) op = bc_num_binD;
+#endif // BC_NUM_BINARY
+	return bc_num_binary(a, b, c, scale, op, BC_NUM_MREQ(a, b));
 }
 
 BcStatus bc_num_mod(BcNum *a, BcNum *b, BcNum *c, size_t scale) {
-	size_t req = BC_NUM_MREQ(a, b, scale);
-	return bc_num_binary(a, b, c, scale, bc_num_rem, req);
+	BcNumBinaryOp op = bc_num_rem;
+	if (bc_num_wordDiv(a, b, c, scale, true)) return BC_STATUS_SUCCESS;
+#if BC_NUM_BINARY
+	if (bc_num_useBin(a, b, !scale && !a->scale && !b->scale))
+		op = bc_num_binRem;
+#endif // BC_NUM_BINARY
+	return bc_num_binary(a, b, c, scale, op, BC_NUM_MREQ(a, b));
 }
 
 BcStatus bc_num_pow(BcNum *a, BcNum *b, BcNum *c, size_t scale) {
+#if BC_NUM_BINARY
+	// Integer powers of binary numbers stay in binary through bc_num_mul().
+	if (a->scale || b->neg) bc_num_toDec(a);
+#endif // BC_NUM_BINARY
 	return bc_num_binary(a, b, c, scale, bc_num_p, a->len * b->len + 1);
 }
 
-BcStatus bc_num_sqrt(BcNum *a, BcNum *restrict b, size_t scale) {
-
-	BcStatus s;
-	BcNum num1, num2, half, f, fprime, *x0, *x1, *temp;
-	size_t pow, len, digs, digs1, resrdx, req, times = 0;
-	ssize_t cmp = 1, cmp1 = SSIZE_MAX, cmp2 = SSIZE_MAX;
-
-	assert(a && b && a != b);
+// Returns the square root of n, rounded down.
+BcBigDig bc_num_sqrtWord(BcBigDig n) {
 
-	req = BC_MAX(scale, a->rdx) + ((BC_NUM_INT(a) + 1) >> 1) + 1;
-	bc_num_expand(b, req);
+	BcBigDig x = n, y = (n + 1) / 2;
 
-	if (a->len == 0) {
-		bc_num_setToZero(b, scale);
-		return BC_STATUS_SUCCESS;
-	}
-	else if (a->neg) return BC_STATUS_MATH_NEGATIVE;
-	else if (BC_NUM_ONE(a)) {
-		bc_num_one(b);
-		bc_num_extend(b, scale);
-		return BC_STATUS_SUCCESS;
+	while (y < x) {
+		x = y;
+		y = (x + n / x) / 2;
 	}
 
-	scale = BC_MAX(scale, a->rdx) + 1;
-	len = a->len + scale;
-
-	bc_num_init(&num1, len);
-	bc_num_init(&num2, len);
-	bc_num_init(&half, BC_NUM_DEF_SIZE);
-
-	bc_num_one(&half);
-	half.num[0] = 5;
-	half.rdx = 1;
+	return x;
+}
 
-	bc_num_init(&f, len);
-	bc_num_init(&fprime, len);
+// Sets r to the square root of the integer n, rounded down. Up from the root
+// of the top two limbs, Newton's method is run until it stops going down.
+// Longer numbers start from one more than the root of their top half (which
+// is also above the root of n) instead. That is good to half of the limbs of
+// the root, one Newton step doubles that, and the remainder fixes the last one.
+BcStatus bc_num_isqrt(BcNum *n, BcNum *restrict r) {
 
-	x0 = &num1;
-	x1 = &num2;
+	BcStatus s;
+	BcNum t, q, one, two;
+	BcBigDig v;
+	size_t i, len = BC_NUM_TOP(n), p = len < 5 ? (len - 1) / 2 : (len - 1) / 4;
+	bool small = len < 5;
 
-	bc_num_one(x0);
-	pow = BC_NUM_INT(a);
+	assert(len && !n->rdx && !n->neg);
 
-	if (pow) {
+	bc_num_init(&t, n->len + 1);
+	bc_num_init(&q, len);
+	bc_num_init(&one, BC_NUM_DEF_SIZE);
+	bc_num_init(&two, BC_NUM_DEF_SIZE);
+	bc_num_one(&one);
+	bc_num_one(&two);
+	two.num[0] = 2;
 
-		if (pow & 1) x0->num[0] = 2;
-		else x0->num[0] = 6;
+	bc_num_copy(&t, n);
+	bc_num_divLimbs(&t, 2 * p);
 
-		pow -= 2 - (pow & 1);
+	if (small) {
 
-		bc_num_extend(x0, pow);
+		for (v = 0, i = t.len - 1; i < t.len; --i)
+			v = v * BC_BASE_POW + (BcBigDig) t.num[i];
+		for (i = 0; i < t.off; ++i) v *= BC_BASE_POW;
 
-		// Make sure to move the radix back.
-		x0->rdx -= pow;
+		s = bc_num_ulong2num(r, (unsigned long) (bc_num_sqrtWord(v) + 1));
+		if (s) goto err;
+		bc_num_clean(r);
+	}
+	else {
+		s = bc_num_isqrt(&t, r);
+		if (s) goto err;
+		s = bc_num_add(r, &one, r, 0);
+		if (s) goto err;
 	}
 
-	x0->rdx = digs = digs1 = 0;
-	resrdx = scale + 2;
-	len = BC_NUM_INT(x0) + resrdx - 1;
+	r->off += p;
 
-	while (!bcg.signe && (cmp != 0 || digs < len)) {
+	do {
 
-		s = bc_num_div(a, x0, &f, resrdx);
+		s = bc_num_d(n, r, &q, 0);
 		if (s) goto err;
-		s = bc_num_add(x0, &f, &fprime, resrdx);
+		s = bc_num_add(&q, r, &t, 0);
 		if (s) goto err;
-		s = bc_num_mul(&fprime, &half, x1, resrdx);
+		s = bc_num_d(&t, &two, &q, 0);
 		if (s) goto err;
 
-		cmp = bc_num_cmp(x1, x0);
-		digs = x1->len - (unsigned long long) llabs(cmp);
+		if (bc_num_cmp(&q, r) >= 0) break;
+
+		bc_num_copy(r, &q);
 
-		if (cmp == cmp2 && digs == digs1) times += 1;
-		else times = 0;
+	} while (small);
 
-		resrdx += times > 4;
+	if (!small) {
 
-		cmp2 = cmp1;
-		cmp1 = cmp;
-		digs1 = digs;
+		s = bc_num_m(r, r, &t, 0);
+		if (s) goto err;
 
-		temp = x0;
-		x0 = x1;
-		x1 = temp;
+		if (bc_num_cmp(&t, n) > 0) s = bc_num_sub(r, &one, r, 0);
 	}
 
-	if (bcg.signe) {
-		s = BC_STATUS_EXEC_SIGNAL;
-		goto err;
+err:
+	bc_num_free(&two);
+	bc_num_free(&one);
+	bc_num_free(&q);
+	bc_num_free(&t);
+	return s;
+}
+
+BcStatus bc_num_sqrt(BcNum *a, BcNum *restrict b, size_t scale) {
+
+	BcStatus s;
+	BcNum n;
+	size_t rdx, req;
+
+	assert(a && b && a != b);
+
+#if BC_NUM_BINARY
+	bc_num_toDec(a);
+#endif // BC_NUM_BINARY
+
+	req = BC_NUM_RDX(BC_MAX(scale, a->scale)) + ((BC_NUM_INT(a) + 1) >> 1) + 1;
+	bc_num_expand(b, req);
+
+	if (a->len == 0) {
+		bc_num_setToZero(b, scale);
+		return BC_STATUS_SUCCESS;
+	}
+	else if (a->neg) return BC_STATUS_MATH_NEGATIVE;
+	else if (BC_NUM_ONE(a)) {
+		bc_num_one(b);
+		bc_num_extend(b, scale);
+		return BC_STATUS_SUCCESS;
 	}
 
-	bc_num_copy(b, x0);
-	scale -= 1;
-	if (b->rdx > scale) bc_num_truncate(b, b->rdx - scale);
+	// The root to scale digits, rounded down, is the integer square root of
+	// a * 10^(2 * scale), with the radix moved back by scale digits.
+	scale = BC_MAX(scale, a->scale);
+	rdx = BC_NUM_RDX(scale);
+
+	bc_num_init(&n, a->len + 2 * rdx + 1);
+	bc_num_copy(&n, a);
+
+	s = bc_num_shift(&n, 2 * scale);
+	if (s) goto err;
+
+	s = bc_num_isqrt(&n, b);
+	if (s) goto err;
+
+	s = bc_num_shift(b, rdx * BC_BASE_DIGS - scale);
+	if (s) goto err;
+
+	b->rdx = rdx;
+	b->scale = scale;
 
 err:
-	bc_num_free(&fprime);
-	bc_num_free(&f);
-	bc_num_free(&half);
-	bc_num_free(&num2);
-	bc_num_free(&num1);
+	bc_num_free(&n);
 	assert(!b->neg || b->len);
 	return s;
 }
@@ -1281,7 +4068,7 @@ BcStatus bc_num_divmod(BcNum *a, BcNum *b, BcNum *c, BcNum *d, size_t scale) {
 	BcStatus s;
 	BcNum num2, *ptr_a;
 	bool init = false;
-	size_t ts = BC_MAX(scale + b->rdx, a->rdx), len = BC_NUM_MREQ(a, b, ts);
+	size_t ts = BC_MAX(scale + b->scale, a->scale), len = BC_NUM_MREQ(a, b);
 
 	assert(c != d && a != b && a != d && b != d && b != c);
 
@@ -1296,6 +4083,11 @@ BcStatus bc_num_divmod(BcNum *a, BcNum *b, BcNum *c, BcNum *d, size_t scale) {
 		bc_num_expand(c, len);
 	}
 
+#if BC_NUM_BINARY
+	if (bc_num_useBin(ptr_a, b, !scale && !ptr_a->scale && !b->scale))
+		s = bc_num_binR(ptr_a, b, c, d);
+	else
+#endif // BC_NUM_BINARY
 	s = bc_num_r(ptr_a, b, c, d, scale, ts);
 
 	assert(!c->neg || c->len);
@@ -1306,56 +4098,176 @@ BcStatus bc_num_divmod(BcNum *a, BcNum *b, BcNum *c, BcNum *d, size_t scale) {
 	return s;
 }
 
-#ifdef DC_ENABLED
+// Puts the integer n in w as words of 32 bits, little-endian, and returns how
+// many there are. w needs room for BC_NUM_TOP(n) of them.
+size_t bc_num_words(BcNum *n, uint32_t *restrict w) {
+
+	BcDig *t;
+	BcBigDig rem;
+	size_t i, len = BC_NUM_TOP(n), nw = 0;
+
+	t = bc_vm_malloc(len * sizeof(BcDig));
+	memset(t, 0, n->off * sizeof(BcDig));
+	memcpy(t + n->off, n->num, n->len * sizeof(BcDig));
+
+	while (len && !t[len - 1]) --len;
+
+	while (len) {
+
+		for (rem = 0, i = len - 1; i < len; --i) {
+			rem = rem * BC_BASE_POW + (BcBigDig) t[i];
+			t[i] = (BcDig) (rem >> 32);
+			rem &= UINT32_MAX;
+		}
+
+		w[nw++] = (uint32_t) rem;
+
+		while (len && !t[len - 1]) --len;
+	}
+
+	free(t);
+
+	return nw;
+}
+
+// Sets r to x mod m, for x below m^2 and m with len limbs, where mu is
+// BC_BASE_POW^(2 * len) / m (Barrett reduction). The quotient estimated from
+// the top limbs of x and mu is at most two too small. t is scratch.
+BcStatus bc_num_barrett(BcNum *x, BcNum *m, BcNum *mu, size_t len,
+                        BcNum *restrict r, BcNum *restrict t)
+{
+	BcStatus s;
+
+	bc_num_copy(r, x);
+	bc_num_divLimbs(r, len - 1);
+
+	s = bc_num_m(r, mu, t, 0);
+	if (s) return s;
+	bc_num_divLimbs(t, len + 1);
+
+	s = bc_num_m(t, m, r, 0);
+	if (s) return s;
+	s = bc_num_sub(x, r, r, 0);
+
+	while (!s && bc_num_cmp(r, m) >= 0) s = bc_num_sub(r, m, r, 0);
+
+	return s;
+}
+
+// Sets r to a * b mod m, where mu and len are as for bc_num_barrett(). The
+// product goes in t, and u is scratch.
+BcStatus bc_num_mulMod(BcNum *a, BcNum *b, BcNum *m, BcNum *mu, size_t len,
+                       BcNum *r, BcNum *restrict t, BcNum *restrict u)
+{
+	BcStatus s = bc_num_m(a, b, t, 0);
+	if (!s) s = bc_num_barrett(t, m, mu, len, r, u);
+	return s;
+}
+
+// The exponent is read from the top in windows of up to w bits that end in a
+// 1 (sliding windows), so besides the squares there is one multiply for each
+// window, by one of the 2^(w - 1) odd powers of the base, found beforehand.
 BcStatus bc_num_modexp(BcNum *a, BcNum *b, BcNum *c, BcNum *restrict d) {
 
 	BcStatus s;
-	BcNum base, exp, two, temp;
+	BcNum base, mod, mu, t, u, pows[1 << (BC_NUM_WINDOW - 1)];
+	uint32_t *e;
+	size_t i, j, len, bits, w, idx, npows = 0;
+	bool one = true;
 
 	assert(a && b && c && d && a != d && b != d && c != d);
 
 	if (c->len == 0) return BC_STATUS_MATH_DIVIDE_BY_ZERO;
+
+#if BC_NUM_BINARY
+	bc_num_toDec(a);
+	bc_num_toDec(b);
+	bc_num_toDec(c);
+#endif // BC_NUM_BINARY
+
 	if (a->rdx || b->rdx || c->rdx) return BC_STATUS_MATH_NON_INTEGER;
 	if (b->neg) return BC_STATUS_MATH_NEGATIVE;
 
 	bc_num_expand(d, c->len);
-	bc_num_init(&base, c->len);
-	bc_num_init(&exp, b->len);
-	bc_num_init(&two, BC_NUM_DEF_SIZE);
-	bc_num_init(&temp, b->len);
-
-	bc_num_one(&two);
-	two.num[0] = 2;
 	bc_num_one(d);
 
-	s = bc_num_rem(a, c, &base, 0);
+	if (b->len == 0) return BC_STATUS_SUCCESS;
+
+	e = bc_vm_malloc(BC_NUM_TOP(b) * sizeof(uint32_t));
+	bits = 32 * bc_num_words(b, e);
+	while (!(e[(bits - 1) / 32] >> ((bits - 1) % 32) & 1)) --bits;
+
+	w = bc_num_window(bits);
+
+	len = BC_NUM_TOP(c);
+	bc_num_init(&mod, c->len);
+	bc_num_init(&mu, len + 2);
+	bc_num_init(&t, 2 * len + 2);
+	bc_num_init(&u, 2 * len + 2);
+
+	bc_num_copy(&mod, c);
+	mod.neg = false;
+
+	bc_num_one(&t);
+	t.off = 2 * len;
+	s = bc_num_d(&t, &mod, &mu, 0);
 	if (s) goto err;
-	bc_num_copy(&exp, b);
 
-	while (exp.len != 0) {
+	memcpy(&base, a, sizeof(BcNum));
+	base.neg = false;
 
-		s = bc_num_divmod(&exp, &two, &exp, &temp, 0);
-		if (s) goto err;
+	bc_num_init(&pows[0], len);
+	npows = 1;
+	s = bc_num_rem(&base, &mod, &pows[0], 0);
+	if (s) goto err;
 
-		if (BC_NUM_ONE(&temp)) {
-			s = bc_num_mul(d, &base, &temp, 0);
-			if (s) goto err;
-			s = bc_num_rem(&temp, c, d, 0);
-			if (s) goto err;
-		}
+	// pows[i] is the base to the power 2 * i + 1; d is used for its square.
+	s = bc_num_mulMod(&pows[0], &pows[0], &mod, &mu, len, d, &t, &u);
 
-		s = bc_num_mul(&base, &base, &temp, 0);
-		if (s) goto err;
-		s = bc_num_rem(&temp, c, &base, 0);
-		if (s) goto err;
+	for (; !s && npows < ((size_t) 1) << (w - 1); ++npows) {
+		bc_num_init(&pows[npows], len);
+		s = bc_num_mulMod(&pows[npows - 1], d, &mod, &mu, len, &pows[npows],
+		                  &t, &u);
 	}
 
+	for (i = bits; !s && !bcg.signe && i > 0; i = j) {
+
+		j = i - 1;
+
+		if (e[j / 32] >> (j % 32) & 1) {
+
+			// The window is from bit i - 1 down to the lowest 1 within w bits.
+			for (j = i > w ? i - w : 0; !(e[j / 32] >> (j % 32) & 1); ++j);
+
+			for (idx = 0; !s && i > j; --i) {
+				idx = idx << 1 | (e[(i - 1) / 32] >> ((i - 1) % 32) & 1);
+				if (!one) s = bc_num_mulMod(d, d, &mod, &mu, len, d, &t, &u);
+			}
+
+			if (s) break;
+
+			idx >>= 1;
+
+			if (one) bc_num_copy(d, &pows[idx]);
+			else s = bc_num_mulMod(d, &pows[idx], &mod, &mu, len, d, &t, &u);
+
+			one = false;
+		}
+		else if (!one) s = bc_num_mulMod(d, d, &mod, &mu, len, d, &t, &u);
+	}
+
+	if (!s && bcg.signe) s = BC_STATUS_EXEC_SIGNAL;
+
+	// Remainders take the sign of the dividend, like bc_num_mod() does.
+	if (!s && a->neg && (e[0] & 1) && d->len) d->neg = true;
+
 err:
-	bc_num_free(&temp);
-	bc_num_free(&two);
-	bc_num_free(&exp);
-	bc_num_free(&base);
+	for (i = 0; i < npows; ++i) bc_num_free(&pows[i]);
+	bc_num_free(&u);
+	bc_num_free(&t);
+	bc_num_free(&mu);
+	bc_num_free(&mod);
+	free(e);
 	assert(!d->neg || d->len);
 	return s;
 }
-#endif // DC_ENABLED
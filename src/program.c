@@ -88,7 +88,7 @@ BcStatus bc_program_num(BcProgram *p, BcResult *r, BcNum **num, bool hex) {
 			size_t base_t, len = strlen(*str);
 			BcNum *base;
 
-			bc_num_init(&r->d.n, len);
+			bc_num_init(&r->d.n, BC_NUM_RDX(len) + 1);
 
 			hex = hex && len == 1;
 			base = hex ? &p->hexb : &p->ib;
@@ -912,18 +912,11 @@ BcStatus bc_program_return(BcProgram *p, char inst) {
 #endif // BC_ENABLED
 
 unsigned long bc_program_scale(BcNum *n) {
-	return (unsigned long) n->rdx;
+	return (unsigned long) n->scale;
 }
 
 unsigned long bc_program_len(BcNum *n) {
-
-	unsigned long len = n->len;
-	size_t i;
-
-	if (n->rdx != n->len) return len;
-	for (i = n->len - 1; i < n->len && n->num[i] == 0; --len, --i);
-
-	return len;
+	return (unsigned long) bc_num_len(n);
 }
 
 BcStatus bc_program_builtin(BcProgram *p, char inst) {
@@ -981,34 +974,6 @@ err:
 	return s;
 }
 
-#ifdef DC_ENABLED
-BcStatus bc_program_divmod(BcProgram *p) {
-
-	BcStatus s;
-	BcResult *opd1, *opd2, res, res2;
-	BcNum *n1, *n2 = NULL;
-
-	s = bc_program_binOpPrep(p, &opd1, &n1, &opd2, &n2, false);
-	if (s) return s;
-
-	bc_num_init(&res.d.n, BC_NUM_DEF_SIZE);
-	bc_num_init(&res2.d.n, n2->len);
-
-	s = bc_num_divmod(n1, n2, &res2.d.n, &res.d.n, p->scale);
-	if (s) goto err;
-
-	bc_program_binOpRetire(p, &res2);
-	res.t = BC_RESULT_TEMP;
-	bc_vec_push(&p->results, &res);
-
-	return s;
-
-err:
-	bc_num_free(&res2.d.n);
-	bc_num_free(&res.d.n);
-	return s;
-}
-
 BcStatus bc_program_modexp(BcProgram *p) {
 
 	BcStatus s;
@@ -1042,6 +1007,11 @@ BcStatus bc_program_modexp(BcProgram *p) {
 	s = bc_num_modexp(n1, n2, n3, &res.d.n);
 	if (s) goto err;
 
+	// dc's | gives 1 for a zero exponent whatever the modulus, but bc's
+	// modexp() is a^b mod c, which is 0 when c is 1 or -1.
+	if (bcg.bc && n3->len == 1 && !n3->off && n3->num[0] == 1)
+		bc_num_zero(&res.d.n);
+
 	bc_vec_pop(&p->results);
 	bc_program_binOpRetire(p, &res);
 
@@ -1052,6 +1022,34 @@ err:
 	return s;
 }
 
+#ifdef DC_ENABLED
+BcStatus bc_program_divmod(BcProgram *p) {
+
+	BcStatus s;
+	BcResult *opd1, *opd2, res, res2;
+	BcNum *n1, *n2 = NULL;
+
+	s = bc_program_binOpPrep(p, &opd1, &n1, &opd2, &n2, false);
+	if (s) return s;
+
+	bc_num_init(&res.d.n, BC_NUM_DEF_SIZE);
+	bc_num_init(&res2.d.n, n2->len);
+
+	s = bc_num_divmod(n1, n2, &res2.d.n, &res.d.n, p->scale);
+	if (s) goto err;
+
+	bc_program_binOpRetire(p, &res2);
+	res.t = BC_RESULT_TEMP;
+	bc_vec_push(&p->results, &res);
+
+	return s;
+
+err:
+	bc_num_free(&res2.d.n);
+	bc_num_free(&res.d.n);
+	return s;
+}
+
 BcStatus bc_program_stackLen(BcProgram *p) {
 
 	BcStatus s;
@@ -1091,7 +1089,7 @@ BcStatus bc_program_asciify(BcProgram *p) {
 
 		bc_num_init(&n, BC_NUM_DEF_SIZE);
 		bc_num_copy(&n, num);
-		bc_num_truncate(&n, n.rdx);
+		bc_num_truncate(&n, n.scale);
 
 		s = bc_num_mod(&n, &p->strmb, &n, 0);
 		if (s) goto num_err;
@@ -1362,8 +1360,7 @@ void bc_program_init(BcProgram *p, size_t line_len,
 	p->ob_t = 10;
 
 	bc_num_init(&p->hexb, BC_NUM_DEF_SIZE);
-	bc_num_ten(&p->hexb);
-	p->hexb.num[0] = 6;
+	bc_num_ulong2num(&p->hexb, BC_NUM_MAX_IBASE);
 
 #ifdef DC_ENABLED
 	bc_num_init(&p->strmb, BC_NUM_DEF_SIZE);
@@ -1661,13 +1658,13 @@ BcStatus bc_program_exec(BcProgram *p) {
 				s = bc_program_assign(p, inst);
 				break;
 			}
-#ifdef DC_ENABLED
+
 			case BC_INST_MODEXP:
 			{
 				s = bc_program_modexp(p);
 				break;
 			}
-
+#ifdef DC_ENABLED
 			case BC_INST_DIVMOD:
 			{
 				s = bc_program_divmod(p);
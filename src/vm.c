@@ -212,6 +212,10 @@ void bc_vm_putchar(int c) {
 	if (putchar(c) == EOF) bc_vm_exit(BC_STATUS_IO_ERR);
 }
 
+void bc_vm_write(const char *str, size_t len) {
+	if (fwrite(str, 1, len, stdout) != len) bc_vm_exit(BC_STATUS_IO_ERR);
+}
+
 void bc_vm_fflush(FILE *restrict f) {
 	if (fflush(f) == EOF) bc_vm_exit(BC_STATUS_IO_ERR);
 }
@@ -401,11 +405,17 @@ BcStatus bc_vm_exec(BcVm *vm) {
 }
 
 void bc_vm_free(BcVm *vm) {
+#if BC_NUM_CACHE_STATS
+	bc_vm_printf(stderr, "reciprocal cache: %zu hits, %zu misses\n",
+	             bcg.cache.hits, bcg.cache.misses);
+#endif // BC_NUM_CACHE_STATS
+	bc_num_cacheFree(&bcg.cache);
 	bc_vec_free(&vm->files);
 	bc_vec_free(&vm->exprs);
 	bc_program_free(&vm->prog);
 	bc_parse_free(&vm->prs);
 	free(vm->env_args);
+	bc_num_poolFree(&bcg.pool);
 }
 
 BcStatus bc_vm_init(BcVm *vm, BcVmExe exe, const char *env_len) {